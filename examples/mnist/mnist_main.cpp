@@ -5,7 +5,14 @@
 #include <memory>
 
 #include "mnist_reader.hpp"
+#include "pjrt/bufferPool.hpp"
 #include "pjrt/client.hpp"
+#include "pjrt/compilationCache.hpp"
+#include "pjrt/constantCache.hpp"
+#include "pjrt/deferredReleaseQueue.hpp"
+#include "pjrt/hostPacker.hpp"
+#include "pjrt/memoryWatermarkSampler.hpp"
+#include "pjrt/normalizingPrologue.hpp"
 
 // Helper function to read a file into a string
 std::string ReadFile(const std::string& file_path) {
@@ -23,9 +30,17 @@ int main() {
     pjrt::Context context;
     pjrt::Client client(context);
 
+    // Every step replaces all parameter and optimizer buffers. Free the old ones in batches on a background thread
+    // instead of inside the training loop. Declared before any buffer so that it outlives them all.
+    pjrt::DeferredReleaseQueue release_queue(context);
+
     // Get PJRT Device
     pjrt::DeviceView device = client.getDevice(/*deviceNumber=*/0);
 
+    // Track device memory high-water marks per phase.
+    pjrt::MemoryWatermarkSampler memory_sampler(device);
+    memory_sampler.setPhase("compile");
+
     // Load and Compile StableHLO Programs
     const std::string kInitModelHloFilename = "init_model.stablehlo";
     const std::string kInitOptimizerHloFilename = "init_optimizer.stablehlo";
@@ -40,12 +55,15 @@ int main() {
     }
     std::cout << "Successfully loaded stablehlo programs" << std::endl;
 
+    // Compiled programs are kept on disk, so that later runs load them instead of compiling them again.
+    pjrt::CompilationCache compilation_cache(client, "compilation_cache");
+
     std::cout << "Parsing & compiling \"" << kInitModelHloFilename << "\"" << std::endl;
     {
       std::ofstream tmpFile("tmp.txt");
       tmpFile << init_model_hlo;
     }
-    pjrt::LoadedExecutable init_model_executable = client.compileFromStableHloString(init_model_hlo);
+    pjrt::LoadedExecutable init_model_executable = compilation_cache.compileFromStableHloString(init_model_hlo);
     std::cout << "Successfully compiled \"" << kInitModelHloFilename << "\"" << std::endl;
 
     std::cout << "Parsing & compiling \"" << kInitOptimizerHloFilename << "\"" << std::endl;
@@ -53,18 +71,10 @@ int main() {
       std::ofstream tmpFile("tmp.txt");
       tmpFile << init_optimizer_hlo;
     }
-    pjrt::LoadedExecutable init_optimizer_executable = client.compileFromStableHloString(init_optimizer_hlo);
+    pjrt::LoadedExecutable init_optimizer_executable = compilation_cache.compileFromStableHloString(init_optimizer_hlo);
     std::cout << "Successfully compiled \"" << kInitOptimizerHloFilename << "\"" << std::endl;
 
-    std::cout << "Parsing & compiling \"" << kTrainStepHloFilename << "\"" << std::endl;
-    {
-      std::ofstream tmpFile("tmp.txt");
-      tmpFile << train_step_hlo;
-    }
-    pjrt::LoadedExecutable train_step_executable = client.compileFromStableHloString(train_step_hlo);
-    std::cout << "Successfully compiled \"" << kTrainStepHloFilename << "\"" << std::endl;
-
-    std::cout << "Successfully initialized PJRT client and compiled HLO programs." << std::endl;
+    std::cout << "Successfully initialized PJRT client and compiled initialization programs." << std::endl;
 
     // Load MNIST Dataset
     mnist::MNIST_dataset<std::vector, uint8_t, uint8_t> dataset =
@@ -77,15 +87,16 @@ int main() {
     std::cout << "Successfully loaded MNIST dataset." << std::endl;
 
     // Initialize Model and Optimizer State
+    memory_sampler.setPhase("init");
     std::cout << "Copying model initializing seed to device" << std::endl;
-    int32_t seed = 0;
-    auto seed_buffer_future = client.transferToDevice(&seed, {}, device);
-    pjrt::Buffer seed_buffer = seed_buffer_future.get();
+    // Constants such as the seed go through a content-addressed cache, so that re-initializing never uploads them again.
+    pjrt::ConstantCache constant_cache(client);
+    const int32_t seed = 0;
+    pjrt::SharedBuffer seed_buffer = constant_cache.get(&seed, {}, device);
     std::cout << "Successfully copied model initializing seed to device" << std::endl;
 
     std::cout << "Initializing model" << std::endl;
-    std::vector<pjrt::Buffer*> init_model_args = {&seed_buffer};
-    auto init_model_result = init_model_executable.execute(device, init_model_args);
+    auto init_model_result = init_model_executable.execute(device, {seed_buffer});
     std::vector<pjrt::Buffer> model_params = init_model_result.get();
     std::cout << "Model initialized, got back " << model_params.size() << " buffers" << std::endl;
 
@@ -97,28 +108,49 @@ int main() {
 
     std::cout << "Successfully initialized model and optimizer." << std::endl;
 
+    // The train step takes the model parameters, the optimizer state, the image batch and the label batch.
+    // Upload images as raw u8 pixels and normalize them to [0, 1] on the device, which transfers a quarter of the bytes.
+    const size_t image_argument_index = model_params.size() + optimizer_state.size();
+    const std::string train_step_u8_hlo = pjrt::addNormalizingPrologue(
+        train_step_hlo, {{image_argument_index, PJRT_Buffer_Type_U8, /*scale=*/1.0 / 255.0}});
+
+    memory_sampler.setPhase("compile");
+    std::cout << "Parsing & compiling \"" << kTrainStepHloFilename << "\"" << std::endl;
+    {
+      std::ofstream tmpFile("tmp.txt");
+      tmpFile << train_step_u8_hlo;
+    }
+    pjrt::LoadedExecutable train_step_executable = compilation_cache.compileFromStableHloString(train_step_u8_hlo);
+    std::cout << "Successfully compiled \"" << kTrainStepHloFilename << "\"" << std::endl;
+    const pjrt::CompilationCache::Stats compilation_stats = compilation_cache.stats();
+    std::cout << "Compilation cache: " << compilation_stats.hits << " hits, " << compilation_stats.misses << " misses" << std::endl;
+
     // Training Loop
     const int num_steps = 4096;
     const int batch_size = 128;
 
+    // Packs the images of each batch across all cores.
+    pjrt::HostPacker packer;
+    std::vector<const uint8_t*> image_rows(batch_size);
+
+    // Every step uploads an image batch and a label batch of the same shapes; recycle their device buffers.
+    pjrt::BufferPool input_pool(client);
+
+    memory_sampler.setPhase("train_step");
     for (int step = 0; step < num_steps; ++step) {
       // Prepare batch
-      std::vector<float> image_batch(batch_size * 28 * 28);
+      std::vector<uint8_t> image_batch(batch_size * 28 * 28);
       std::vector<int32_t> label_batch(batch_size);
       for (int i = 0; i < batch_size; ++i) {
         int image_index = (step * batch_size + i) % dataset.training_images.size();
-        for (int j = 0; j < 28 * 28; ++j) {
-          image_batch[i * 28 * 28 + j] = static_cast<float>(dataset.training_images[image_index][j]) / 255.0f;
-        }
+        image_rows[i] = dataset.training_images[image_index].data();
         label_batch[i] = static_cast<int32_t>(dataset.training_labels[image_index]);
       }
+      packer.gather(image_batch.data(), reinterpret_cast<const void *const *>(image_rows.data()), batch_size, 28 * 28);
 
       // Transfer data to device
-      std::future<pjrt::Buffer> image_buffer_future = client.transferToDevice(image_batch.data(), {batch_size, 28, 28, 1}, device);
-      std::future<pjrt::Buffer> label_buffer_future = client.transferToDevice(label_batch.data(), {batch_size}, device);
-
-      pjrt::Buffer image_buffer = image_buffer_future.get();
-      pjrt::Buffer label_buffer = label_buffer_future.get();
+      pjrt::Buffer image_buffer = input_pool.upload(image_batch.data(), {batch_size, 28, 28, 1}, device);
+      pjrt::Buffer label_buffer = input_pool.upload(label_batch.data(), {batch_size}, device);
 
       // Execute training step
       std::vector<pjrt::Buffer*> argument_buffers;
@@ -147,14 +179,41 @@ int main() {
       }
       pjrt::Buffer loss_buffer = std::move(train_step_result[state_buffers_end_idx]);
 
+      // The step has completed, so its inputs can be reused by the next one.
+      input_pool.release(std::move(image_buffer));
+      input_pool.release(std::move(label_buffer));
+
       // Report loss
-      std::future<std::vector<float>> loss_future = loss_buffer.toHost<float>();
-      std::vector<float> loss_vec = loss_future.get();
-      float loss = loss_vec[0];
+      std::future<float> loss_future = loss_buffer.toHostScalar<float>();
+      float loss = loss_future.get();
       auto endTime = std::chrono::high_resolution_clock::now();
       auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
       std::cout << "Step " << step << ": Loss = " << loss << " (" << duration << " us)" << std::endl;
     }
+
+    memory_sampler.stop();
+    if (memory_sampler.supported()) {
+      for (const pjrt::MemoryWatermarkSampler::PhaseWatermark &watermark : memory_sampler.watermarks()) {
+        std::cout << "Device memory during " << watermark.phase << ": peak " << watermark.peakBytesInUse << " bytes in use";
+        if (watermark.bytesLimit) {
+          std::cout << " of " << *watermark.bytesLimit;
+        }
+        if (watermark.minLargestFreeBlockBytes) {
+          std::cout << ", smallest largest free block " << *watermark.minLargestFreeBlockBytes << " bytes";
+        }
+        std::cout << " (" << watermark.numSamples << " samples)" << std::endl;
+      }
+    } else {
+      std::cout << "The PJRT plugin does not report device memory statistics." << std::endl;
+    }
+
+    const pjrt::BufferPool::Stats pool_stats = input_pool.stats();
+    std::cout << "Input buffer pool: " << pool_stats.hits << " hits, " << pool_stats.misses << " misses (hit rate " << pool_stats.hitRate()
+              << "), " << pool_stats.inPlaceUploads << " in-place uploads, " << pool_stats.residentBytes << " bytes resident" << std::endl;
+
+    const pjrt::DeferredReleaseQueue::Stats release_stats = release_queue.stats();
+    std::cout << "Deferred release: " << release_stats.buffersFreed << " buffers (" << release_stats.bytesFreed << " bytes) freed in "
+              << release_stats.batches << " batches, peak queue length " << release_stats.peakQueueLength << std::endl;
   } catch (const std::exception& e) {
     std::cerr << "Error: " << e.what() << std::endl;
     return 1;
@@ -0,0 +1,106 @@
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/hostPacker.hpp"
+#include "pjrt/normalizingPrologue.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int64_t kBatchSize = 128;
+constexpr int64_t kImageSize = 28 * 28;
+
+// Stands in for a training step which consumes a batch of normalized images: sums each image.
+const std::string kStepProgram = R"delim(
+module @jit_step attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<128x784xf32>) -> (tensor<128xf32> {jax.result_info = "result"}) {
+    %cst = stablehlo.constant dense<0.000000e+00> : tensor<f32>
+    %0 = stablehlo.reduce(%arg0 init: %cst) applies stablehlo.add across dimensions = [1] : (tensor<128x784xf32>, tensor<f32>) -> tensor<128xf32>
+    return %0 : tensor<128xf32>
+  }
+})delim";
+
+struct Result {
+  double microsecondsPerStep;
+  size_t bytesPerStep;
+};
+
+template <typename PrepareAndUpload>
+Result run(const pjrt::DeviceView &device, pjrt::LoadedExecutable &executable, int numSteps, size_t bytesPerStep, PrepareAndUpload prepareAndUpload) {
+  const auto start = std::chrono::steady_clock::now();
+  for (int step = 0; step < numSteps; ++step) {
+    pjrt::Buffer input = prepareAndUpload(step);
+    std::vector<pjrt::Buffer*> arguments = {&input};
+    executable.execute(device, arguments).get();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return Result{std::chrono::duration<double, std::micro>(end - start).count() / numSteps, bytesPerStep};
+}
+
+void report(const std::string &name, const Result &result) {
+  std::cout << name << ": " << result.bytesPerStep << " bytes transferred per step, " << result.microsecondsPerStep << " us per step" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const int numSteps = (argc > 1 ? std::stoi(argv[1]) : 1000);
+
+  try {
+    pjrt::Context context;
+    pjrt::Client client(context);
+    pjrt::DeviceView device = client.getDevice(/*deviceNumber=*/0);
+    std::cout << "Platform: " << client.platformName() << ", " << numSteps << " steps" << std::endl;
+
+    // A synthetic dataset of raw pixels, as stored on disk.
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> pixel(0, 255);
+    std::vector<std::vector<uint8_t>> images(4096, std::vector<uint8_t>(kImageSize));
+    for (std::vector<uint8_t> &image : images) {
+      for (uint8_t &value : image) {
+        value = static_cast<uint8_t>(pixel(generator));
+      }
+    }
+
+    pjrt::HostPacker packer;
+    std::vector<const uint8_t*> rows(kBatchSize);
+    auto selectRows = [&](int step) {
+      for (int64_t i = 0; i < kBatchSize; ++i) {
+        rows[i] = images[(step * kBatchSize + i) % images.size()].data();
+      }
+    };
+
+    // Baseline: normalize on the host and upload f32.
+    pjrt::LoadedExecutable floatExecutable = client.compileFromStableHloString(kStepProgram);
+    std::vector<float> floatBatch(kBatchSize * kImageSize);
+    const Result floatResult = run(device, floatExecutable, numSteps, floatBatch.size() * sizeof(float), [&](int step) {
+      selectRows(step);
+      packer.gatherConvert(floatBatch.data(), rows.data(), kBatchSize, kImageSize, 1.0f / 255.0f);
+      return client.transferToDevice(floatBatch.data(), {kBatchSize, kImageSize}, device).get();
+    });
+
+    // Upload raw u8 and normalize on the device.
+    pjrt::LoadedExecutable u8Executable = client.compileFromStableHloString(
+        pjrt::addNormalizingPrologue(kStepProgram, {{/*index=*/0, PJRT_Buffer_Type_U8, /*scale=*/1.0 / 255.0}}));
+    std::vector<uint8_t> u8Batch(kBatchSize * kImageSize);
+    const Result u8Result = run(device, u8Executable, numSteps, u8Batch.size(), [&](int step) {
+      selectRows(step);
+      packer.gather(u8Batch.data(), reinterpret_cast<const void *const *>(rows.data()), kBatchSize, kImageSize);
+      return client.transferToDevice(u8Batch.data(), {kBatchSize, kImageSize}, device).get();
+    });
+
+    report("f32, normalized on host  ", floatResult);
+    report("u8, normalized on device ", u8Result);
+    std::cout << "Transfer size reduced " << static_cast<double>(floatResult.bytesPerStep) / u8Result.bytesPerStep
+              << "x, step time changed " << floatResult.microsecondsPerStep / u8Result.microsecondsPerStep << "x" << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,144 @@
+#include "admissionController.hpp"
+#include "exception.hpp"
+#include "loadedExecutable.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace pjrt {
+
+AdmissionController::Admission::Admission(Admission &&other) : controller_(other.controller_), bytes_(other.bytes_) {
+  other.controller_ = nullptr;
+  other.bytes_ = 0;
+}
+
+AdmissionController::Admission& AdmissionController::Admission::operator=(Admission &&other) {
+  if (this != &other) {
+    release();
+    controller_ = other.controller_;
+    bytes_ = other.bytes_;
+    other.controller_ = nullptr;
+    other.bytes_ = 0;
+  }
+  return *this;
+}
+
+AdmissionController::Admission::~Admission() {
+  release();
+}
+
+void AdmissionController::Admission::release() {
+  if (controller_ == nullptr) {
+    return;
+  }
+  controller_->release(bytes_);
+  controller_ = nullptr;
+  bytes_ = 0;
+}
+
+AdmissionController::AdmissionController(const DeviceView &device, Options options) : device_(device), options_(options) {
+  std::optional<int64_t> bytesLimit;
+  try {
+    bytesLimit = device_.memoryStats().bytesLimit;
+  } catch (const pjrt::Exception &) {
+    deviceStatsSupported_ = false;
+  }
+  if (options_.capacityBytes) {
+    capacityBytes_ = *options_.capacityBytes;
+  } else if (bytesLimit) {
+    capacityBytes_ = *bytesLimit;
+  } else {
+    throw pjrt::Exception("The device does not report its memory limit; pass AdmissionController::Options::capacityBytes.");
+  }
+}
+
+AdmissionController::~AdmissionController() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  assert(((void)"AdmissionController destroyed while memory is still reserved", stats_.reservedBytes == 0));
+  assert(((void)"AdmissionController destroyed while launches are waiting for admission", stats_.queueLength == 0));
+}
+
+int64_t AdmissionController::footprint(const LoadedExecutable &executable, bool allowDonation) {
+  const std::optional<CompiledMemoryStats> &stats = executable.compiledMemoryStats();
+  if (!stats) {
+    throw pjrt::Exception("The PJRT plugin does not report compiled memory statistics, so launches cannot be admitted by footprint.");
+  }
+  const int64_t aliasedBytes = (allowDonation ? stats->aliasSizeInBytes : 0);
+  return stats->tempSizeInBytes + std::max<int64_t>(stats->outputSizeInBytes - aliasedBytes, 0);
+}
+
+AdmissionController::Admission AdmissionController::admit(int64_t bytes) {
+  if (bytes > capacityBytes_ - options_.headroomBytes) {
+    throw pjrt::Exception("A launch needing " + std::to_string(bytes) + " bytes can never be admitted within a capacity of " + std::to_string(capacityBytes_) + " bytes and " + std::to_string(options_.headroomBytes) + " bytes of headroom.");
+  }
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  const uint64_t ticket = nextTicket_++;
+  ++stats_.queueLength;
+  stats_.peakQueueLength = std::max(stats_.peakQueueLength, stats_.queueLength);
+  bool waited = false;
+  while (true) {
+    if (ticket == servingTicket_) {
+      const int64_t available = capacityBytes_ - options_.headroomBytes - deviceBytesInUse() - stats_.reservedBytes;
+      // With nothing reserved, waiting cannot free any memory the controller knows about, so admit rather than deadlock.
+      if (bytes <= available || stats_.reservedBytes == 0) {
+        break;
+      }
+    }
+    waited = true;
+    if (ticket == servingTicket_ && deviceStatsSupported_) {
+      // Memory freed outside of the controller sends no notification, so only the head of the queue polls for it.
+      wakeUp_.wait_for(lock, options_.pollInterval);
+    } else {
+      // Woken by release() and by the admission of the launch ahead.
+      wakeUp_.wait(lock);
+    }
+  }
+  ++servingTicket_;
+  --stats_.queueLength;
+  ++stats_.admitted;
+  if (waited) {
+    ++stats_.queued;
+    stats_.waitTime += std::chrono::steady_clock::now() - start;
+  }
+  stats_.reservedBytes += bytes;
+  stats_.peakReservedBytes = std::max(stats_.peakReservedBytes, stats_.reservedBytes);
+  // The next ticket may fit as well.
+  wakeUp_.notify_all();
+  return Admission(this, bytes);
+}
+
+std::future<std::vector<Buffer>> AdmissionController::execute(LoadedExecutable &executable, std::vector<Buffer*> &arguments, bool allowDonation) {
+  // Held by the execution's callback data, so the reservation lasts until the execution has completed.
+  std::shared_ptr<const Admission> admission = std::make_shared<const Admission>(admit(footprint(executable, allowDonation)));
+  return executable.executeBuffers(device_, arguments, allowDonation, std::move(admission));
+}
+
+AdmissionController::Stats AdmissionController::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void AdmissionController::release(int64_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.reservedBytes -= bytes;
+  // The head of the queue may fit now.
+  wakeUp_.notify_all();
+}
+
+int64_t AdmissionController::deviceBytesInUse() {
+  if (!deviceStatsSupported_) {
+    return 0;
+  }
+  try {
+    return device_.memoryStats().bytesInUse;
+  } catch (const pjrt::Exception &) {
+    deviceStatsSupported_ = false;
+    return 0;
+  }
+}
+
+} // namespace pjrt
@@ -0,0 +1,117 @@
+#ifndef PJRT_ADMISSION_CONTROLLER_HPP_
+#define PJRT_ADMISSION_CONTROLLER_HPP_
+
+#include "buffer.hpp"
+#include "deviceView.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace pjrt {
+
+class LoadedExecutable;
+
+// Admits launches on a device only when the memory they need is free, instead of finding out from a failed
+// PJRT_LoadedExecutable_Execute. A launch needs its compiled temporaries plus its outputs, less those which reuse donated
+// arguments when donation is allowed; free memory is the device's capacity minus what its allocator reports in use, minus
+// what admitted launches have reserved. Launches which do not fit wait in FIFO order, so a large launch is not starved by a
+// stream of small ones.
+//
+// Reservations are held until the execution completes. Memory a running launch has already allocated is counted both as
+// in use and as reserved, so admission errs on the side of caution. If the plugin reports no memory statistics, only
+// reservations are counted against the capacity. A launch which does not fit even with nothing reserved is admitted
+// anyway, since waiting for other launches could not help it.
+//
+// `device` must outlive the controller, and the controller must outlive its admissions. Thread-safe.
+class AdmissionController {
+public:
+  struct Options {
+    // Memory to admit launches against. If unset, the bytesLimit which the device reports is used.
+    std::optional<int64_t> capacityBytes;
+    // Kept free at all times, e.g. for allocations made outside of admitted launches.
+    int64_t headroomBytes{0};
+    // How often the launch at the head of the queue re-checks the device's memory while waiting, since memory freed
+    // outside of the controller sends no notification. Launches behind it, and the head if the device reports no memory
+    // statistics, sleep until a reservation is released or the head is admitted.
+    std::chrono::milliseconds pollInterval{5};
+  };
+
+  struct Stats {
+    uint64_t admitted{0};
+    // Admissions which had to wait for memory or for earlier launches.
+    uint64_t queued{0};
+    size_t queueLength{0};
+    size_t peakQueueLength{0};
+    int64_t reservedBytes{0};
+    int64_t peakReservedBytes{0};
+    std::chrono::nanoseconds waitTime{0};
+  };
+
+  // Device memory reserved by admit(), which is returned when the Admission is destroyed or released.
+  class Admission {
+  public:
+    Admission(Admission &&other);
+    Admission& operator=(Admission &&other);
+    Admission(const Admission &) = delete;
+    Admission& operator=(const Admission &) = delete;
+    ~Admission();
+
+    int64_t bytes() const { return bytes_; }
+    void release();
+  private:
+    friend class AdmissionController;
+    Admission(AdmissionController *controller, int64_t bytes) : controller_(controller), bytes_(bytes) {}
+
+    AdmissionController *controller_{nullptr};
+    int64_t bytes_{0};
+  };
+
+  // Throws if no capacity is given and the device does not report a bytesLimit.
+  AdmissionController(const DeviceView &device, Options options);
+  explicit AdmissionController(const DeviceView &device) : AdmissionController(device, Options()) {}
+  AdmissionController(const AdmissionController &) = delete;
+  AdmissionController& operator=(const AdmissionController &) = delete;
+  // Requires that every admission has been released, including those held by executions started through execute(), i.e.
+  // that stats().reservedBytes is 0, and that no caller is waiting in admit().
+  ~AdmissionController();
+
+  // Device memory an execution of `executable` needs beyond its arguments. Outputs aliased to arguments only reuse their
+  // memory if the arguments are donated, so without `allowDonation` every output counts. Throws if the plugin does not
+  // report compiled memory statistics.
+  static int64_t footprint(const LoadedExecutable &executable, bool allowDonation = true);
+
+  // Blocks until `bytes` fit, after every earlier caller has been admitted. Throws if `bytes` exceeds the capacity.
+  Admission admit(int64_t bytes);
+
+  // Admits a launch of `executable`, then executes it on the controller's device. The reservation is released once the
+  // execution has completed.
+  std::future<std::vector<Buffer>> execute(LoadedExecutable &executable, std::vector<Buffer*> &arguments, bool allowDonation = true);
+
+  Stats stats() const;
+private:
+  void release(int64_t bytes);
+  // Bytes the device's allocator reports in use, or 0 if it does not report statistics. Called with mutex_ held.
+  int64_t deviceBytesInUse();
+
+  const DeviceView &device_;
+  const Options options_;
+  int64_t capacityBytes_{0};
+  bool deviceStatsSupported_{true};
+
+  mutable std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  // Callers are admitted in the order of their tickets.
+  uint64_t nextTicket_{0};
+  uint64_t servingTicket_{0};
+  Stats stats_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_ADMISSION_CONTROLLER_HPP_
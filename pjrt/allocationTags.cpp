@@ -0,0 +1,66 @@
+#include "allocationTags.hpp"
+
+#include <utility>
+
+namespace pjrt {
+
+namespace {
+
+thread_local AllocationTag currentTag;
+
+} // namespace
+
+namespace detail {
+
+void AllocationTagCounters::charge(int64_t bytes) {
+  const int64_t live = liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  liveBuffers.fetch_add(1, std::memory_order_relaxed);
+  totalBuffers.fetch_add(1, std::memory_order_relaxed);
+  int64_t peak = peakBytes.load(std::memory_order_relaxed);
+  while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void AllocationTagCounters::refund(int64_t bytes) {
+  liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+  liveBuffers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+AllocationTag AllocationTagRegistry::tag(const std::string &name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_ptr<detail::AllocationTagCounters> &counters = tags_[name];
+  if (counters == nullptr) {
+    counters = std::make_unique<detail::AllocationTagCounters>(*this, name);
+  }
+  return AllocationTag(counters.get());
+}
+
+std::vector<AllocationTagUsage> AllocationTagRegistry::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<AllocationTagUsage> usage;
+  usage.reserve(tags_.size());
+  for (const auto &[name, counters] : tags_) {
+    AllocationTagUsage &entry = usage.emplace_back();
+    entry.tag = name;
+    entry.liveBytes = counters->liveBytes.load(std::memory_order_relaxed);
+    entry.liveBuffers = counters->liveBuffers.load(std::memory_order_relaxed);
+    entry.peakBytes = counters->peakBytes.load(std::memory_order_relaxed);
+    entry.totalBuffers = counters->totalBuffers.load(std::memory_order_relaxed);
+    entry.untrackedBuffers = counters->untrackedBuffers.load(std::memory_order_relaxed);
+  }
+  return usage;
+}
+
+AllocationTagScope::AllocationTagScope(AllocationTag tag) : previous_(std::exchange(currentTag, tag)) {}
+
+AllocationTagScope::~AllocationTagScope() {
+  currentTag = previous_;
+}
+
+AllocationTag AllocationTagScope::current() {
+  return currentTag;
+}
+
+} // namespace pjrt
@@ -0,0 +1,99 @@
+#ifndef PJRT_ALLOCATION_TAGS_HPP_
+#define PJRT_ALLOCATION_TAGS_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pjrt {
+
+class AllocationTagRegistry;
+
+namespace detail {
+
+// Live usage of one tag, updated without locking by every Buffer which carries it.
+struct AllocationTagCounters {
+  AllocationTagCounters(const AllocationTagRegistry &owner, std::string tagName) : registry(owner), name(std::move(tagName)) {}
+
+  void charge(int64_t bytes);
+  void refund(int64_t bytes);
+
+  const AllocationTagRegistry &registry;
+  const std::string name;
+  std::atomic<int64_t> liveBytes{0};
+  std::atomic<int64_t> liveBuffers{0};
+  std::atomic<int64_t> peakBytes{0};
+  std::atomic<uint64_t> totalBuffers{0};
+  std::atomic<uint64_t> untrackedBuffers{0};
+};
+
+} // namespace detail
+
+// The owner device memory is attributed to, e.g. a model or a subsystem. Obtained from Context::allocationTag() and cheap
+// to copy. A default-constructed tag attributes nothing.
+class AllocationTag {
+public:
+  AllocationTag() = default;
+
+  explicit operator bool() const { return counters_ != nullptr; }
+  // Empty for the default-constructed tag.
+  std::string name() const { return (counters_ != nullptr ? counters_->name : std::string()); }
+  // Whether the tag was obtained from `registry`. The empty tag belongs to every registry.
+  bool belongsTo(const AllocationTagRegistry &registry) const { return counters_ == nullptr || &counters_->registry == &registry; }
+
+  friend bool operator==(const AllocationTag &lhs, const AllocationTag &rhs) { return lhs.counters_ == rhs.counters_; }
+  friend bool operator!=(const AllocationTag &lhs, const AllocationTag &rhs) { return !(lhs == rhs); }
+// private:
+  explicit AllocationTag(detail::AllocationTagCounters *counters) : counters_(counters) {}
+
+  detail::AllocationTagCounters *counters_{nullptr};
+};
+
+// A snapshot of the device memory attributed to one tag. Sizes are the buffers' on-device sizes.
+struct AllocationTagUsage {
+  std::string tag;
+  int64_t liveBytes{0};
+  int64_t liveBuffers{0};
+  int64_t peakBytes{0};
+  // Buffers ever attributed to the tag, including those freed since.
+  uint64_t totalBuffers{0};
+  // Buffers created inside a scope for the tag whose size could not be queried. They are missing from the counts above.
+  uint64_t untrackedBuffers{0};
+};
+
+// Interns tags by name. Their counters live as long as the registry, i.e. as long as the owning Context.
+class AllocationTagRegistry {
+public:
+  AllocationTag tag(const std::string &name);
+
+  // Usage of every tag ever requested, ordered by name.
+  std::vector<AllocationTagUsage> snapshot() const;
+private:
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<detail::AllocationTagCounters>> tags_;
+};
+
+// Attributes every Buffer created on this thread while the scope is alive to `tag`: uploads, allocations, copies and
+// execution outputs alike. Scopes nest; the innermost one wins. Use Buffer::setAllocationTag() to re-attribute a single
+// buffer afterwards. The scope is per thread rather than per Context, so Buffers of any other Context created inside it
+// are left untagged.
+class AllocationTagScope {
+public:
+  explicit AllocationTagScope(AllocationTag tag);
+  AllocationTagScope(const AllocationTagScope &) = delete;
+  AllocationTagScope& operator=(const AllocationTagScope &) = delete;
+  ~AllocationTagScope();
+
+  // The tag of the innermost scope on this thread, or the empty tag outside of any scope.
+  static AllocationTag current();
+private:
+  AllocationTag previous_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_ALLOCATION_TAGS_HPP_
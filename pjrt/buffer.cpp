@@ -1,7 +1,10 @@
 #include "buffer.hpp"
 #include "context.hpp"
 #include "detail/callbackUserData.hpp"
+#include "deviceView.hpp"
+#include "dlpack.hpp"
 #include "event.hpp"
+#include "memoryView.hpp"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -15,17 +18,80 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <memory>
 #include <stdexcept>
 
 namespace pjrt {
 
+namespace detail {
+
+void decreaseExternalReferenceCount(const Context &context, PJRT_Buffer *buffer) noexcept {
+  PJRT_Buffer_DecreaseExternalReferenceCount_Args args;
+  args.struct_size = PJRT_Buffer_DecreaseExternalReferenceCount_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer;
+  PJRT_Error *pjrtError = context.pjrtApi_->PJRT_Buffer_DecreaseExternalReferenceCount(&args);
+  if (pjrtError != nullptr) {
+    const pjrt::Exception ex = context.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_DecreaseExternalReferenceCount", __FILE__, __LINE__);
+    std::cerr << "Failed to release external reference to PJRT_Buffer: \"" << ex.what() << "\"" << std::endl;
+  }
+}
+
+} // namespace detail
+
+namespace {
+
+// Everything which a DLManagedTensor produced by Buffer::toDLPack() owns.
+struct DLPackExport {
+  const Context *context;
+  PJRT_Buffer *buffer;
+  std::vector<int64_t> shape;
+  std::vector<int64_t> strides;
+  DLManagedTensor managedTensor;
+};
+
+void dlpackExportDeleter(DLManagedTensor *self) {
+  DLPackExport *exported = static_cast<DLPackExport*>(self->manager_ctx);
+  const Context &context = *exported->context;
+
+  // The deleter is called from foreign code and must not throw.
+  detail::decreaseExternalReferenceCount(context, exported->buffer);
+
+  PJRT_Buffer_Destroy_Args destroyArgs;
+  destroyArgs.struct_size = PJRT_Buffer_Destroy_Args_STRUCT_SIZE;
+  destroyArgs.extension_start = nullptr;
+  destroyArgs.buffer = exported->buffer;
+  PJRT_Error *pjrtError = context.pjrtApi_->PJRT_Buffer_Destroy(&destroyArgs);
+  if (pjrtError != nullptr) {
+    const pjrt::Exception ex = context.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_Destroy", __FILE__, __LINE__);
+    std::cerr << "DLPack deleter failed to destroy PJRT_Buffer: \"" << ex.what() << "\"" << std::endl;
+  }
+  delete exported;
+}
+
+} // namespace
+
 Buffer::Buffer(const Context &context) : context_(context), dimensions_() {}
 
-Buffer::Buffer(const Context &context, PJRT_Buffer *buffer, const std::vector<int64_t> &dims) : context_(context), buffer_(buffer), dimensions_(dims) {}
+Buffer::Buffer(const Context &context, PJRT_Buffer *buffer, const Shape &dims) : context_(context), buffer_(buffer), dimensions_(dims) {
+  const AllocationTag tag = AllocationTagScope::current();
+  // The scope may have been opened for another Context, whose registry this Buffer must not charge.
+  if (tag && buffer_ != nullptr && tag.belongsTo(context_.allocationTags_)) {
+    try {
+      setAllocationTag(tag);
+    } catch (const pjrt::Exception &) {
+      // Attribution must not cost the caller the buffer. Count the miss, so that the tag's usage shows it is incomplete.
+      tag.counters_->untrackedBuffers.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
 
-Buffer::Buffer(Buffer &&other) : context_(other.context_), buffer_(other.buffer_), dimensions_(std::move(other.dimensions_)) {
+Buffer::Buffer(Buffer &&other) : context_(other.context_), buffer_(other.buffer_), dimensions_(std::move(other.dimensions_)), metadata_(std::move(other.metadata_)), allocationTag_(other.allocationTag_), taggedBytes_(other.taggedBytes_) {
   // Set source's buffer to nullptr so that it does not try to free that resource on destruction.
   other.buffer_ = nullptr;
+  other.metadata_ = Metadata();
+  other.allocationTag_ = nullptr;
+  other.taggedBytes_ = 0;
 }
 
 Buffer& Buffer::operator=(Buffer &&other) {
@@ -37,18 +103,26 @@ Buffer& Buffer::operator=(Buffer &&other) {
     return *this;
   }
 
-  const std::optional<pjrt::Exception> exception = privateDestroyBuffer();
-  if (exception) {
-    throw exception.value();
+  if (!deferDestroyBuffer()) {
+    const std::optional<pjrt::Exception> exception = privateDestroyBuffer();
+    if (exception) {
+      throw exception.value();
+    }
   }
 
   this->buffer_ = other.buffer_;
+  this->metadata_ = std::move(other.metadata_);
+  this->allocationTag_ = other.allocationTag_;
+  this->taggedBytes_ = other.taggedBytes_;
   other.buffer_ = nullptr;
+  other.metadata_ = Metadata();
+  other.allocationTag_ = nullptr;
+  other.taggedBytes_ = 0;
   return *this;
 }
 
 Buffer::~Buffer() {
-  if (buffer_ == nullptr) {
+  if (buffer_ == nullptr || deferDestroyBuffer()) {
     return;
   }
   const std::optional<pjrt::Exception> exception = privateDestroyBuffer();
@@ -70,6 +144,401 @@ void Buffer::destroy() {
   throw exception.value();
 }
 
+PJRT_Buffer_Type Buffer::elementType() const {
+  if (metadata_.elementType) {
+    return *metadata_.elementType;
+  }
+  PJRT_Buffer_ElementType_Args args;
+  args.struct_size = PJRT_Buffer_ElementType_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_ElementType(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_ElementType", __FILE__, __LINE__);
+  }
+  metadata_.elementType = args.type;
+  return args.type;
+}
+
+DeviceView Buffer::device() const {
+  if (metadata_.device == nullptr) {
+    PJRT_Buffer_Device_Args args;
+    args.struct_size = PJRT_Buffer_Device_Args_STRUCT_SIZE;
+    args.extension_start = nullptr;
+    args.buffer = buffer_;
+    PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_Device(&args);
+    if (pjrtError != nullptr) {
+      throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_Device", __FILE__, __LINE__);
+    }
+    metadata_.device = args.device;
+  }
+  return DeviceView(context_, metadata_.device);
+}
+
+MemoryView Buffer::memory() const {
+  if (metadata_.memory == nullptr) {
+    PJRT_Buffer_Memory_Args args;
+    args.struct_size = PJRT_Buffer_Memory_Args_STRUCT_SIZE;
+    args.extension_start = nullptr;
+    args.buffer = buffer_;
+    PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_Memory(&args);
+    if (pjrtError != nullptr) {
+      throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_Memory", __FILE__, __LINE__);
+    }
+    metadata_.memory = args.memory;
+  }
+  return MemoryView(context_, metadata_.memory);
+}
+
+const MemoryLayout& Buffer::memoryLayout() const {
+  if (!metadata_.memoryLayout) {
+    PJRT_Buffer_GetMemoryLayout_Args args;
+    args.struct_size = PJRT_Buffer_GetMemoryLayout_Args_STRUCT_SIZE;
+    args.extension_start = nullptr;
+    args.buffer = buffer_;
+    PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_GetMemoryLayout(&args);
+    if (pjrtError != nullptr) {
+      throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_GetMemoryLayout", __FILE__, __LINE__);
+    }
+    // The arrays in args.layout belong to the buffer, so copy them out.
+    metadata_.memoryLayout = MemoryLayout::fromCLayout(args.layout);
+  }
+  return *metadata_.memoryLayout;
+}
+
+size_t Buffer::onDeviceSizeInBytes() const {
+  if (metadata_.onDeviceSizeInBytes) {
+    return *metadata_.onDeviceSizeInBytes;
+  }
+  PJRT_Buffer_OnDeviceSizeInBytes_Args args;
+  args.struct_size = PJRT_Buffer_OnDeviceSizeInBytes_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_OnDeviceSizeInBytes(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_OnDeviceSizeInBytes", __FILE__, __LINE__);
+  }
+  metadata_.onDeviceSizeInBytes = args.on_device_size_in_bytes;
+  return args.on_device_size_in_bytes;
+}
+
+size_t Buffer::hostSizeInBytes() const {
+  if (!metadata_.hostSizeInBytes) {
+    metadata_.hostSizeInBytes = queryHostBufferSize();
+  }
+  return *metadata_.hostSizeInBytes;
+}
+
+bool Buffer::isOnCpu() const {
+  if (metadata_.isOnCpu) {
+    return *metadata_.isOnCpu;
+  }
+  PJRT_Buffer_IsOnCpu_Args args;
+  args.struct_size = PJRT_Buffer_IsOnCpu_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_IsOnCpu(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_IsOnCpu", __FILE__, __LINE__);
+  }
+  metadata_.isOnCpu = args.is_on_cpu;
+  return args.is_on_cpu;
+}
+
+bool Buffer::isDeleted() const {
+  PJRT_Buffer_IsDeleted_Args args;
+  args.struct_size = PJRT_Buffer_IsDeleted_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_IsDeleted(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_IsDeleted", __FILE__, __LINE__);
+  }
+  return args.is_deleted;
+}
+
+void Buffer::awaitReady() const {
+  PJRT_Buffer_ReadyEvent_Args args;
+  args.struct_size = PJRT_Buffer_ReadyEvent_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_ReadyEvent(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_ReadyEvent", __FILE__, __LINE__);
+  }
+  // Event destroys the PJRT_Event, even if waiting throws.
+  Event event(context_, args.event);
+  event.wait();
+}
+
+DLManagedTensor* Buffer::toDLPack() {
+  const DLDataType dataType = detail::toDLDataType(elementType());
+
+  // DLPack describes layouts with per-dimension strides, in elements.
+  const MemoryLayout &layout = memoryLayout();
+  if (layout.type() != PJRT_Buffer_MemoryLayout_Type_Tiled || layout.numTiles() != 0) {
+    throw pjrt::Exception("Only dense, untiled buffers can be exported to DLPack.");
+  }
+  std::vector<int64_t> strides(dimensions_.size());
+  int64_t stride = 1;
+  for (const int64_t dimension : layout.minorToMajor()) {
+    strides[dimension] = stride;
+    stride *= dimensions_[dimension];
+  }
+
+  DLDevice dlDevice;
+  if (isOnCpu()) {
+    dlDevice.device_type = kDLCPU;
+    dlDevice.device_id = 0;
+  } else {
+    dlDevice.device_type = kDLCUDA;
+    dlDevice.device_id = device().localHardwareId();
+  }
+
+  // The consumer may read the data as soon as it has the tensor.
+  awaitReady();
+
+  // Pin the device memory before asking where it is.
+  PJRT_Buffer_IncreaseExternalReferenceCount_Args increaseArgs;
+  increaseArgs.struct_size = PJRT_Buffer_IncreaseExternalReferenceCount_Args_STRUCT_SIZE;
+  increaseArgs.extension_start = nullptr;
+  increaseArgs.buffer = buffer_;
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_IncreaseExternalReferenceCount(&increaseArgs);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_IncreaseExternalReferenceCount", __FILE__, __LINE__);
+  }
+
+  PJRT_Buffer_OpaqueDeviceMemoryDataPointer_Args pointerArgs;
+  pointerArgs.struct_size = PJRT_Buffer_OpaqueDeviceMemoryDataPointer_Args_STRUCT_SIZE;
+  pointerArgs.extension_start = nullptr;
+  pointerArgs.buffer = buffer_;
+  pjrtError = context_.pjrtApi_->PJRT_Buffer_OpaqueDeviceMemoryDataPointer(&pointerArgs);
+  if (pjrtError != nullptr) {
+    const pjrt::Exception exception = context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_OpaqueDeviceMemoryDataPointer", __FILE__, __LINE__);
+    // Undo the pin; the original failure is the one reported.
+    detail::decreaseExternalReferenceCount(context_, buffer_);
+    throw exception;
+  }
+
+  DLPackExport *exported = new DLPackExport{&context_, buffer_, dimensions_.toVector(), std::move(strides), {}};
+  DLTensor &tensor = exported->managedTensor.dl_tensor;
+  tensor.data = pointerArgs.device_memory_ptr;
+  tensor.device = dlDevice;
+  tensor.ndim = static_cast<int32_t>(exported->shape.size());
+  tensor.dtype = dataType;
+  tensor.shape = exported->shape.data();
+  tensor.strides = exported->strides.data();
+  tensor.byte_offset = 0;
+  exported->managedTensor.manager_ctx = exported;
+  exported->managedTensor.deleter = &dlpackExportDeleter;
+
+  // The DLManagedTensor now owns the PJRT_Buffer, and its memory is no longer attributed to anyone.
+  refundAllocationTag();
+  buffer_ = nullptr;
+  metadata_ = Metadata();
+  return &exported->managedTensor;
+}
+
+Buffer Buffer::copyToDevice(const DeviceView &device) const {
+  PJRT_Buffer_CopyToDevice_Args args;
+  args.struct_size = PJRT_Buffer_CopyToDevice_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  args.dst_device = device.device_;
+  // args.dst_buffer will be populated.
+
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_CopyToDevice(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_CopyToDevice", __FILE__, __LINE__);
+  }
+  return Buffer(context_, args.dst_buffer, dimensions_);
+}
+
+Buffer Buffer::copyToMemory(const MemoryView &memory) const {
+  PJRT_Buffer_CopyToMemory_Args args;
+  args.struct_size = PJRT_Buffer_CopyToMemory_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  args.dst_memory = memory.memory_;
+  // args.dst_buffer will be populated.
+
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_CopyToMemory(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_CopyToMemory", __FILE__, __LINE__);
+  }
+  return Buffer(context_, args.dst_buffer, dimensions_);
+}
+
+std::future<void> Buffer::copyRawToHost(void *data, int64_t offset, int64_t transferSize) const {
+  PJRT_Buffer_CopyRawToHost_Args args;
+  args.struct_size = PJRT_Buffer_CopyRawToHost_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  args.dst = data;
+  args.offset = offset;
+  args.transfer_size = transferSize;
+  args.event = nullptr;
+
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_CopyRawToHost(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_CopyRawToHost", __FILE__, __LINE__);
+  }
+
+  auto callbackUserData = std::make_unique<detail::CallbackUserData<void>>(context_);
+  return context_.getFutureForEvent(args.event, std::move(callbackUserData));
+}
+
+size_t Buffer::queryHostBufferSize(const MemoryLayout *hostLayout) const {
+  // The PJRT struct only needs to outlive the call.
+  PJRT_Buffer_MemoryLayout cHostLayout;
+  if (hostLayout != nullptr) {
+    cHostLayout = hostLayout->c_layout();
+  }
+
+  PJRT_Buffer_ToHostBuffer_Args bthh_args;
+  bthh_args.struct_size = PJRT_Buffer_ToHostBuffer_Args_STRUCT_SIZE;
+  bthh_args.extension_start = nullptr;
+  bthh_args.src = buffer_;
+  bthh_args.dst = nullptr;
+  // bthh_args.dst_size will be populated.
+  bthh_args.host_layout = (hostLayout != nullptr ? &cHostLayout : nullptr); // Null means use default/source layout
+  bthh_args.event = nullptr;
+
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_ToHostBuffer(&bthh_args);
+  if (pjrtError != nullptr) {
+    // TODO: The PJRT documentation does not say whether or not we need to free the event in the args struct in the case of an error. My current guess is that we do not.
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_ToHostBuffer", __FILE__, __LINE__);
+  }
+
+  assert(((void)"There should be no event when simply querying size", bthh_args.event == nullptr));
+  return bthh_args.dst_size;
+}
+
+PJRT_Event* Buffer::issueToHostBuffer(void *dst, size_t dstSize, const MemoryLayout *hostLayout) const {
+  PJRT_Buffer_MemoryLayout cHostLayout;
+  if (hostLayout != nullptr) {
+    cHostLayout = hostLayout->c_layout();
+  }
+
+  PJRT_Buffer_ToHostBuffer_Args bthh_args;
+  bthh_args.struct_size = PJRT_Buffer_ToHostBuffer_Args_STRUCT_SIZE;
+  bthh_args.extension_start = nullptr;
+  bthh_args.src = buffer_;
+  bthh_args.dst = dst;
+  bthh_args.dst_size = dstSize;
+  bthh_args.host_layout = (hostLayout != nullptr ? &cHostLayout : nullptr); // Null means use default/source layout
+  bthh_args.event = nullptr;
+
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_ToHostBuffer(&bthh_args);
+  if (pjrtError != nullptr) {
+    // TODO: The PJRT documentation does not say whether or not we need to free the event in the args struct in the case of an error. My current guess is that we do not.
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_ToHostBuffer", __FILE__, __LINE__);
+  }
+  return bthh_args.event;
+}
+
+const void* Buffer::pinHostMemory() const {
+  // The host representation matches the device one only for dense, major-to-minor layouts.
+  if (!isOnCpu() || !memoryLayout().isDenseMajorToMinor()) {
+    return nullptr;
+  }
+  awaitReady();
+
+  PJRT_Buffer_IncreaseExternalReferenceCount_Args increaseArgs;
+  increaseArgs.struct_size = PJRT_Buffer_IncreaseExternalReferenceCount_Args_STRUCT_SIZE;
+  increaseArgs.extension_start = nullptr;
+  increaseArgs.buffer = buffer_;
+  PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_IncreaseExternalReferenceCount(&increaseArgs);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_IncreaseExternalReferenceCount", __FILE__, __LINE__);
+  }
+
+  PJRT_Buffer_UnsafePointer_Args pointerArgs;
+  pointerArgs.struct_size = PJRT_Buffer_UnsafePointer_Args_STRUCT_SIZE;
+  pointerArgs.extension_start = nullptr;
+  pointerArgs.buffer = buffer_;
+  pjrtError = context_.pjrtApi_->PJRT_Buffer_UnsafePointer(&pointerArgs);
+  if (pjrtError != nullptr) {
+    const pjrt::Exception exception = context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_UnsafePointer", __FILE__, __LINE__);
+    detail::decreaseExternalReferenceCount(context_, buffer_);
+    throw exception;
+  }
+  return reinterpret_cast<const void*>(pointerArgs.buffer_pointer);
+}
+
+void Buffer::setAllocationTag(AllocationTag tag) {
+  if (!tag.belongsTo(context_.allocationTags_)) {
+    throw pjrt::Exception("Allocation tag \"" + tag.name() + "\" belongs to another Context than the buffer.");
+  }
+  // Query first, so that a failure leaves the current attribution in place.
+  const int64_t bytes = (tag && buffer_ != nullptr ? static_cast<int64_t>(onDeviceSizeInBytes()) : 0);
+  refundAllocationTag();
+  if (!tag || buffer_ == nullptr) {
+    return;
+  }
+  tag.counters_->charge(bytes);
+  allocationTag_ = tag.counters_;
+  taggedBytes_ = bytes;
+}
+
+void Buffer::refundAllocationTag() const {
+  if (allocationTag_ == nullptr) {
+    return;
+  }
+  allocationTag_->refund(taggedBytes_);
+  allocationTag_ = nullptr;
+  taggedBytes_ = 0;
+}
+
+void Buffer::invalidateHostMirror() const {
+  const std::shared_ptr<detail::HostMirror> mirror = std::atomic_load(&metadata_.hostMirror);
+  if (mirror != nullptr) {
+    mirror->invalidate();
+  }
+}
+
+std::shared_ptr<detail::HostMirror> Buffer::hostMirror() const {
+  std::shared_ptr<detail::HostMirror> mirror = std::atomic_load(&metadata_.hostMirror);
+  if (mirror != nullptr) {
+    return mirror;
+  }
+  std::shared_ptr<detail::HostMirror> created = std::make_shared<detail::HostMirror>();
+  // If another thread got there first, `mirror` is updated to its slot.
+  if (std::atomic_compare_exchange_strong(&metadata_.hostMirror, &mirror, created)) {
+    return created;
+  }
+  return mirror;
+}
+
+void Buffer::forgetIfDonated() const {
+  // Only buffers which hold a readback from mirroredToHost() or are tagged pay for the isDeleted() query.
+  const std::shared_ptr<detail::HostMirror> mirror = std::atomic_load(&metadata_.hostMirror);
+  const bool mirrored = (mirror != nullptr && mirror->hasReadback());
+  if (!mirrored && allocationTag_ == nullptr) {
+    return;
+  }
+  if (buffer_ != nullptr && !isDeleted()) {
+    return;
+  }
+  if (mirrored) {
+    mirror->invalidate();
+  }
+  refundAllocationTag();
+}
+
+bool Buffer::deferDestroyBuffer() {
+  if (buffer_ == nullptr) {
+    return true;
+  }
+  if (!context_.deferBufferRelease(buffer_)) {
+    return false;
+  }
+  refundAllocationTag();
+  buffer_ = nullptr;
+  metadata_ = Metadata();
+  return true;
+}
+
 std::optional<pjrt::Exception> Buffer::privateDestroyBuffer() {
   if (buffer_ == nullptr) {
     return {};
@@ -80,6 +549,9 @@ std::optional<pjrt::Exception> Buffer::privateDestroyBuffer() {
   destroy_args.buffer = buffer_;
   PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_Destroy(&destroy_args);
   if (pjrtError == nullptr) {
+    refundAllocationTag();
+    buffer_ = nullptr;
+    metadata_ = Metadata();
     return {};
   }
   return context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_Destroy", __FILE__, __LINE__);
@@ -1,9 +1,15 @@
 #ifndef PJRT_BUFFER_HPP_
 #define PJRT_BUFFER_HPP_
 
+#include "pjrt/allocationTags.hpp"
 #include "pjrt/context.hpp"
 #include "pjrt/detail/callbackUserData.hpp"
+#include "pjrt/detail/hostMirror.hpp"
+#include "pjrt/detail/types.hpp"
 #include "pjrt/event.hpp"
+#include "pjrt/hostView.hpp"
+#include "pjrt/memoryLayout.hpp"
+#include "pjrt/shape.hpp"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -19,69 +25,241 @@
 #include <cstdint>
 #include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
+struct DLManagedTensor;
 struct PJRT_Buffer;
+struct PJRT_Device;
+struct PJRT_Memory;
 
 namespace pjrt {
 
+class DeviceView;
+class HostArena;
+class LoadedExecutable;
+class MemoryView;
+class RawBuffer;
+
 class Buffer {
 public:
   Buffer(const Context &context);
-  Buffer(const Context &context, PJRT_Buffer *buffer, const std::vector<int64_t> &dims);
+  Buffer(const Context &context, PJRT_Buffer *buffer, const Shape &dims);
   Buffer(Buffer &&other);
 
   Buffer& operator=(Buffer &&other);
 
-  const std::vector<int64_t>& dimensions() const { return dimensions_; }
+  const Shape& dimensions() const { return dimensions_; }
   PJRT_Buffer* c_buffer() const { return buffer_; }
 
+  // The properties below cannot change during the lifetime of a PJRT_Buffer. Each one is queried from PJRT the first time it is
+  // asked for and cached from then on, so hot paths may call them freely. Filling the cache is not synchronized; if several
+  // threads share a Buffer, query the properties they need once before sharing it.
+  PJRT_Buffer_Type elementType() const;
+  // The device which stores this buffer.
+  DeviceView device() const;
+  // The memory space, e.g. "device" or "pinned_host", which stores this buffer.
+  MemoryView memory() const;
+  // The layout of the buffer's storage on its device.
+  const MemoryLayout& memoryLayout() const;
+
+  // Size of the buffer's storage on its device, which may include padding required by the device layout.
+  size_t onDeviceSizeInBytes() const;
+
+  // Number of bytes toHost() writes when the buffer is copied to the host in its own layout.
+  size_t hostSizeInBytes() const;
+
+  // Whether the buffer's memory is directly addressable from the host, e.g. on the CPU plugin.
+  bool isOnCpu() const;
+
+  // Whether the device memory has been released, e.g. because the buffer was donated to an execution.
+  bool isDeleted() const;
+
+  // Attributes this buffer's on-device size to `tag` instead of its current tag, if any. An empty tag removes the attribution.
+  // Buffers created inside an AllocationTagScope are tagged on construction. The attribution moves with the Buffer and ends
+  // when it gives up its PJRT_Buffer, e.g. on destruction, replacement, donation to an execution or export to DLPack. Throws if `tag` was obtained from
+  // another Context.
+  void setAllocationTag(AllocationTag tag);
+  AllocationTag allocationTag() const { return AllocationTag(allocationTag_); }
+
+  // Blocks until the buffer's data has been computed or transferred. Throws if producing the data failed.
+  void awaitReady() const;
+
   // Attempts to clean up resources, will not throw. If cleanup fails, resources may be leaked.
   ~Buffer();
 
   // Cleanup resources held. May throw.
   void destroy();
 
+  // Exports this buffer as a DLPack tensor without copying, for consumption by other in-process libraries.
+  // Ownership of the underlying PJRT_Buffer moves into the returned tensor and this Buffer is left empty.
+  // The device memory is pinned with an external reference until the consumer calls the tensor's deleter.
+  // Blocks until the buffer is ready, so that the consumer can read the data right away.
+  // Only dense layouts are supported. Non-CPU buffers are reported as kDLCUDA devices.
+  DLManagedTensor* toDLPack();
+
+  // Copies this buffer to another device of the same client without going through the host.
+  // The copy happens asynchronously; the returned buffer may be used right away, e.g. as an argument to execute().
+  // PJRT reports an error if the buffer already lives on `device`.
+  Buffer copyToDevice(const DeviceView &device) const;
+
+  // Copies this buffer into another memory space, e.g. from "device" to "pinned_host" memory or back.
+  // Like copyToDevice(), the copy is asynchronous. PJRT reports an error if the buffer already lives in `memory`.
+  Buffer copyToMemory(const MemoryView &memory) const;
+
   template<typename T>
-  std::future<std::vector<T>> toHost() {
-    // First, query the API to check the required size of the output.
-    PJRT_Buffer_ToHostBuffer_Args bthh_args;
-    bthh_args.struct_size = PJRT_Buffer_ToHostBuffer_Args_STRUCT_SIZE;
-    bthh_args.extension_start = nullptr;
-    bthh_args.src = buffer_;
-    bthh_args.dst = nullptr;
-    // bthh_args.dst_size will be populated.
-    bthh_args.host_layout = nullptr; // Use default/source layout
-    bthh_args.event = nullptr;
-
-    PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_ToHostBuffer(&bthh_args);
-    if (pjrtError != nullptr) {
-      // TODO: The PJRT documentation does not say whether or not we need to free the event in the args struct in the case of an error. My current guess is that we do not.
-      throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_ToHostBuffer", __FILE__, __LINE__);
-    }
+  std::future<std::vector<T>> toHost() const {
+    // Only the first read of a buffer queries the API for the required size of the output.
+    const size_t hostBufferSize = hostSizeInBytes();
 
-    assert(((void)"There should be no event when simply querying size", bthh_args.event == nullptr));
-    
     auto callbackUserData = std::make_unique<detail::CallbackUserData<std::vector<T>>>(context_);
     std::vector<T> &hostData = callbackUserData->getData();
-    hostData.resize(bthh_args.dst_size / sizeof(T));
-    bthh_args.dst = hostData.data();
+    hostData.resize(hostBufferSize / sizeof(T));
 
-    pjrtError = context_.pjrtApi_->PJRT_Buffer_ToHostBuffer(&bthh_args);
-    if (pjrtError != nullptr) {
-      // TODO: The PJRT documentation does not say whether or not we need to free the event in the args struct in the case of an error. My current guess is that we do not.
-      throw context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_ToHostBuffer", __FILE__, __LINE__);
+    PJRT_Event *event = issueToHostBuffer(hostData.data(), hostBufferSize);
+    return context_.getFutureForEvent(event, std::move(callbackUserData));
+  }
+
+  // Asynchronously copies the buffer into caller-provided memory. `data` must have room for `count` elements and must stay alive until the future is ready.
+  // No size query is issued and nothing is allocated for the data; PJRT reports an error if `count` elements is too small to hold the buffer.
+  template<typename T>
+  std::future<void> toHost(T *data, size_t count) const {
+    auto callbackUserData = std::make_unique<detail::CallbackUserData<void>>(context_);
+    PJRT_Event *event = issueToHostBuffer(data, count * sizeof(T));
+    return context_.getFutureForEvent(event, std::move(callbackUserData));
+  }
+
+  // Asynchronously copies the buffer to the host, having the plugin relayout the data into `hostLayout` during the copy.
+  // This avoids a separate transpose pass on the host, e.g. when a consumer wants NCHW but the device produced NHWC.
+  // Plugins are not required to support every layout; strided host layouts in particular are often unimplemented.
+  template<typename T>
+  std::future<std::vector<T>> toHost(const MemoryLayout &hostLayout) const {
+    const size_t hostBufferSize = queryHostBufferSize(&hostLayout);
+
+    auto callbackUserData = std::make_unique<detail::CallbackUserData<std::vector<T>>>(context_);
+    std::vector<T> &hostData = callbackUserData->getData();
+    hostData.resize(hostBufferSize / sizeof(T));
+
+    PJRT_Event *event = issueToHostBuffer(hostData.data(), hostBufferSize, &hostLayout);
+    return context_.getFutureForEvent(event, std::move(callbackUserData));
+  }
+
+  // Caller-provided memory version of the above. See toHost(T*, size_t) for the requirements on `data`.
+  template<typename T>
+  std::future<void> toHost(T *data, size_t count, const MemoryLayout &hostLayout) const {
+    auto callbackUserData = std::make_unique<detail::CallbackUserData<void>>(context_);
+    PJRT_Event *event = issueToHostBuffer(data, count * sizeof(T), &hostLayout);
+    return context_.getFutureForEvent(event, std::move(callbackUserData));
+  }
+
+  // Blocks until the buffer is ready and returns its elements for reading on the host.
+  // If the buffer is on the CPU and densely laid out, the view points directly at the buffer's memory, so nothing is copied;
+  // see HostView for the lifetime rules in that case. Otherwise the data is copied as by toHost().
+  // Throws if the buffer's element type is not T.
+  template<typename T>
+  HostView<T> hostView() const {
+    if (elementType() != detail::TypeToPjrtBufferType<T>()) {
+      throw pjrt::Exception("hostView() called with a type which does not match the buffer's element type.");
+    }
+    const void *data = pinHostMemory();
+    if (data == nullptr) {
+      return HostView<T>(toHost<T>().get());
+    }
+    return HostView<T>(context_, buffer_, static_cast<const T*>(data), hostSizeInBytes() / sizeof(T));
+  }
+
+  // Like toHost<T>(), but keeps the result as a host mirror of the buffer. Later calls return the same readback without another
+  // transfer, and concurrent callers share a single readback rather than issuing one each. Calling with a different T
+  // replaces the mirror. If the readback fails, the returned future holds the error until the mirror is invalidated.
+  //
+  // The mirror is dropped when the buffer is replaced or destroyed, when it is donated to an execution, and when it is
+  // written through a RawBuffer. While such a write is in flight, every call issues its own readback and none is kept.
+  // Changes the library cannot see require a call to invalidateHostMirror().
+  template<typename T>
+  std::shared_future<std::vector<T>> mirroredToHost() const {
+    constexpr PJRT_Buffer_Type kType = detail::TypeToPjrtBufferType<T>();
+    const std::shared_ptr<detail::HostMirror> mirror = hostMirror();
+    std::lock_guard<std::mutex> lock(mirror->mutex);
+    if (mirror->writesInFlight > 0) {
+      return toHost<T>().share();
+    }
+    if (mirror->readback == nullptr || mirror->type != kType) {
+      mirror->readback = std::make_shared<const std::shared_future<std::vector<T>>>(toHost<T>().share());
+      mirror->type = kType;
     }
-    
-    return context_.getFutureForEvent(bthh_args.event, std::move(callbackUserData));
+    return *std::static_pointer_cast<const std::shared_future<std::vector<T>>>(mirror->readback);
+  }
+
+  // Drops the host mirror, if any. The next mirroredToHost() reads the buffer again.
+  void invalidateHostMirror() const;
+
+  // Asynchronously reads a buffer which holds a single element, such as a scalar loss.
+  // The value is written directly into the callback's storage, so no host vector is allocated and no size query is issued.
+  template<typename T>
+  std::future<T> toHostScalar() const {
+    auto callbackUserData = std::make_unique<detail::CallbackUserData<T>>(context_);
+    PJRT_Event *event = issueToHostBuffer(&callbackUserData->getData(), sizeof(T));
+    return context_.getFutureForEvent(event, std::move(callbackUserData));
   }
+
+  // Asynchronously copies `transferSize` bytes, starting `offset` bytes into the buffer's on-device representation, into `data`.
+  // For the default (dense, major-to-minor) layout, byte offsets match those of the host representation.
+  // `data` must stay alive until the future is ready.
+  std::future<void> copyRawToHost(void *data, int64_t offset, int64_t transferSize) const;
 private:
+  friend class LoadedExecutable;
+  friend class RawBuffer;
+  friend std::future<HostArena> readbackAll(const std::vector<Buffer*> &buffers);
+
   const Context &context_;
   PJRT_Buffer *buffer_{nullptr};
-  const std::vector<int64_t> dimensions_;
+  const Shape dimensions_;
+
+  // Properties of buffer_ which have been queried so far. Reset whenever buffer_ changes.
+  struct Metadata {
+    std::optional<PJRT_Buffer_Type> elementType;
+    std::optional<size_t> onDeviceSizeInBytes;
+    std::optional<size_t> hostSizeInBytes;
+    std::optional<MemoryLayout> memoryLayout;
+    std::optional<bool> isOnCpu;
+    PJRT_Device *device{nullptr};
+    PJRT_Memory *memory{nullptr};
+    // Created on first use, then only accessed through std::atomic_load() and friends, so that concurrent readers agree on it.
+    std::shared_ptr<detail::HostMirror> hostMirror;
+  };
+  mutable Metadata metadata_;
+
+  // The tag buffer_ is attributed to, and the bytes charged to it. Mutable because donation, which const arguments undergo
+  // too, ends the attribution.
+  mutable detail::AllocationTagCounters *allocationTag_{nullptr};
+  mutable int64_t taggedBytes_{0};
 
   std::optional<pjrt::Exception> privateDestroyBuffer();
+
+  // Ends the attribution of buffer_ to its tag. Called whenever this Buffer stops owning buffer_, or buffer_ is donated.
+  void refundAllocationTag() const;
+
+  // Returns the host mirror slot of buffer_, creating it if needed. The slot holds no readback until mirroredToHost().
+  std::shared_ptr<detail::HostMirror> hostMirror() const;
+
+  // If buffer_ has been donated to an execution, drops its host mirror and ends its attribution to its tag, since the
+  // memory now belongs to the execution's output.
+  void forgetIfDonated() const;
+
+  // If the buffer's host representation can be read in place, waits for it to be ready, takes an external reference on it and
+  // returns its address. Otherwise returns null.
+  const void* pinHostMemory() const;
+
+  // Hands buffer_ to the Context's DeferredReleaseQueue, if one is attached. Returns whether buffer_ has been taken care of.
+  bool deferDestroyBuffer();
+
+  // Returns the number of bytes required to hold this buffer on the host. A null `hostLayout` means the buffer's own layout.
+  size_t queryHostBufferSize(const MemoryLayout *hostLayout = nullptr) const;
+
+  // Starts an asynchronous copy into `dst`, which holds `dstSize` bytes. Returns the event which signals completion of the copy.
+  PJRT_Event* issueToHostBuffer(void *dst, size_t dstSize, const MemoryLayout *hostLayout = nullptr) const;
 };
 
 } // namespace pjrt
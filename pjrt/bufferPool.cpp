@@ -0,0 +1,118 @@
+#include "bufferPool.hpp"
+#include "context.hpp"
+#include "deviceView.hpp"
+#include "rawBuffer.hpp"
+
+#include <utility>
+
+namespace pjrt {
+
+BufferPool::BufferPool(const Client &client, size_t maxResidentBytes) : client_(client), maxResidentBytes_(maxResidentBytes), rawBufferSupported_(RawBuffer::isSupported(client.context_)) {}
+
+Buffer BufferPool::acquire(const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device) {
+  std::optional<Buffer> pooled = take(Key(shape, type, device.device_));
+  if (pooled) {
+    return std::move(*pooled);
+  }
+  return client_.allocate(shape, type, device);
+}
+
+std::optional<Buffer> BufferPool::take(const Key &key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = buffers_.find(key);
+  if (it == buffers_.end() || it->second.empty()) {
+    ++stats_.misses;
+    return std::nullopt;
+  }
+  ++stats_.hits;
+  PooledBuffer pooled = std::move(it->second.back());
+  it->second.pop_back();
+  --stats_.residentBuffers;
+  stats_.residentBytes -= pooled.sizeInBytes;
+  return std::move(pooled.buffer);
+}
+
+void BufferPool::discardOne(const Key &key) {
+  std::optional<Buffer> discarded;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buffers_.find(key);
+    if (it == buffers_.end() || it->second.empty()) {
+      return;
+    }
+    PooledBuffer pooled = std::move(it->second.back());
+    it->second.pop_back();
+    --stats_.residentBuffers;
+    stats_.residentBytes -= pooled.sizeInBytes;
+    ++stats_.evictions;
+    discarded.emplace(std::move(pooled.buffer));
+  }
+  // Destroyed outside of the lock.
+}
+
+std::optional<Buffer> BufferPool::uploadInPlace(const void *data, const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device) {
+  if (!rawBufferSupported_) {
+    discardOne(Key(shape, type, device.device_));
+    return std::nullopt;
+  }
+  Buffer buffer = acquire(shape, type, device);
+  if (!buffer.memoryLayout().isDenseMajorToMinor()) {
+    // Buffers of this kind can never be written in place. Drop this one rather than pooling it again, since the caller
+    // allocates its replacement with a transfer.
+    return std::nullopt;
+  }
+
+  size_t sizeInBytes = detail::byteSizeOf(type);
+  for (int64_t dim : shape) {
+    sizeInBytes *= dim;
+  }
+  RawBuffer rawBuffer(buffer);
+  rawBuffer.write(data, /*offset=*/0, static_cast<int64_t>(sizeInBytes)).get();
+  rawBuffer.destroy();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.inPlaceUploads;
+  }
+  return std::optional<Buffer>(std::move(buffer));
+}
+
+void BufferPool::release(Buffer &&buffer) {
+  Buffer released(std::move(buffer));
+  if (released.c_buffer() == nullptr || released.isDeleted()) {
+    // Nothing left to recycle, e.g. after donation. The destructor frees the handle.
+    return;
+  }
+  const size_t sizeInBytes = released.onDeviceSizeInBytes();
+  Key key(released.dimensions(), released.elementType(), released.device().device_);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stats_.residentBytes + sizeInBytes > maxResidentBytes_) {
+    ++stats_.evictions;
+    return;
+  }
+  buffers_[std::move(key)].push_back(PooledBuffer{std::move(released), sizeInBytes});
+  ++stats_.residentBuffers;
+  stats_.residentBytes += sizeInBytes;
+}
+
+void BufferPool::clear() {
+  std::map<Key, std::vector<PooledBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers.swap(buffers_);
+    stats_.residentBuffers = 0;
+    stats_.residentBytes = 0;
+  }
+  for (auto &[key, pooled] : buffers) {
+    for (PooledBuffer &entry : pooled) {
+      entry.buffer.destroy();
+    }
+  }
+}
+
+BufferPool::Stats BufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+} // namespace pjrt
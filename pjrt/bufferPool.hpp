@@ -0,0 +1,117 @@
+#ifndef PJRT_BUFFER_POOL_HPP_
+#define PJRT_BUFFER_POOL_HPP_
+
+#include "buffer.hpp"
+#include "client.hpp"
+#include "detail/types.hpp"
+#include "shape.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace pjrt {
+
+class DeviceView;
+
+// Recycles device buffers by (shape, element type, device), so that steady-state loops stop going through the device allocator.
+//
+// Buffers enter the pool through release(), e.g. the inputs of the previous step once its execution has completed.
+// A released buffer must not be read by a pending execution anymore, since its memory may be overwritten by the next upload().
+// Buffers which were donated to an execution are not pooled. `client` must outlive the pool. Thread-safe.
+class BufferPool {
+public:
+  struct Stats {
+    // Requests served from the pool.
+    size_t hits{0};
+    // Requests which needed a new allocation.
+    size_t misses{0};
+    // upload() calls which wrote into a pooled or newly allocated buffer, rather than creating one with a transfer.
+    size_t inPlaceUploads{0};
+    // Buffers destroyed instead of pooled, because the pool was over budget, or freed because a fallback upload() allocated
+    // a new buffer in their place.
+    size_t evictions{0};
+    size_t residentBuffers{0};
+    size_t residentBytes{0};
+
+    double hitRate() const { return (hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses)); }
+  };
+
+  // The pool holds at most `maxResidentBytes` of idle buffers.
+  explicit BufferPool(const Client &client, size_t maxResidentBytes = std::numeric_limits<size_t>::max());
+
+  // Returns a pooled buffer of the given shape and type on `device`, or allocates one. The contents are unspecified.
+  Buffer acquire(const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device);
+
+  template <typename T>
+  Buffer acquire(const Shape &shape, const DeviceView &device) {
+    return acquire(shape, detail::TypeToPjrtBufferType<T>(), device);
+  }
+
+  // Returns a buffer holding a copy of `data`. `data` may be reused as soon as this returns.
+  // If the plugin supports the RawBuffer extension, the data is written into a pooled buffer in place. Otherwise this falls
+  // back to Client::transferToDevice(), which always allocates, and frees one idle buffer of the same kind instead of reusing
+  // it, so that releasing the results of upload() does not grow the pool without bound.
+  template <typename T>
+  Buffer upload(const T *data, const Shape &shape, const DeviceView &device) {
+    std::optional<Buffer> buffer = uploadInPlace(data, shape, detail::TypeToPjrtBufferType<T>(), device);
+    if (buffer) {
+      return std::move(*buffer);
+    }
+    return client_.transferToDevice(data, shape, device).get();
+  }
+
+  // Hands a buffer which is no longer needed back to the pool.
+  void release(Buffer &&buffer);
+
+  // Destroys every idle buffer.
+  void clear();
+
+  Stats stats() const;
+private:
+  using Key = std::tuple<Shape, PJRT_Buffer_Type, PJRT_Device*>;
+
+  struct PooledBuffer {
+    Buffer buffer;
+    size_t sizeInBytes;
+  };
+
+  // Takes a pooled buffer for `key`, if there is one.
+  std::optional<Buffer> take(const Key &key);
+
+  // Destroys one idle buffer for `key`, if there is one.
+  void discardOne(const Key &key);
+
+  // Writes `data` into an acquired buffer with the RawBuffer extension. Returns nullopt if that is not possible, after
+  // giving up one idle buffer for the allocation which the caller makes instead.
+  std::optional<Buffer> uploadInPlace(const void *data, const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device);
+
+  const Client &client_;
+  const size_t maxResidentBytes_;
+  const bool rawBufferSupported_;
+
+  mutable std::mutex mutex_;
+  std::map<Key, std::vector<PooledBuffer>> buffers_;
+  Stats stats_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_BUFFER_POOL_HPP_
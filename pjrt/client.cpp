@@ -1,22 +1,93 @@
 #include "client.hpp"
 #include "context.hpp"
+#include "detail/compileOptions.hpp"
+#include "dlpack.hpp"
 #include "event.hpp"
+#include "memoryLayout.hpp"
 
+#include <algorithm>
 #include <cstring>
+#include <numeric>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <variant>
 #include <vector>
 
 namespace pjrt {
 
-Client::Client(const Context &context) : context_(context) {
+namespace {
+
+// Called by PJRT once a view created by Client::fromDLPack() no longer uses the memory.
+void dlpackViewDeleted(void * /*deviceBufferPtr*/, void *userArgument) {
+  DLManagedTensor *managedTensor = static_cast<DLManagedTensor*>(userArgument);
+  if (managedTensor->deleter != nullptr) {
+    managedTensor->deleter(managedTensor);
+  }
+}
+
+// Returns the layout described by DLPack `strides` (in elements), or nullopt for the default major-to-minor layout.
+std::optional<MemoryLayout> layoutFromDLPackStrides(const std::vector<int64_t> &dims, const int64_t *strides) {
+  // Order dimensions from most minor to most major. Ties (only possible with dimensions of size 1) keep the major-to-minor order.
+  std::vector<int64_t> minorToMajor(dims.size());
+  std::iota(minorToMajor.rbegin(), minorToMajor.rend(), 0);
+  std::stable_sort(minorToMajor.begin(), minorToMajor.end(), [&](int64_t lhs, int64_t rhs) {
+    return strides[lhs] < strides[rhs];
+  });
+
+  int64_t expectedStride = 1;
+  for (int64_t dimension : minorToMajor) {
+    if (dims[dimension] != 1 && strides[dimension] != expectedStride) {
+      throw pjrt::Exception("Only dense DLPack tensors are supported.");
+    }
+    expectedStride *= dims[dimension];
+  }
+
+  if (std::is_sorted(minorToMajor.rbegin(), minorToMajor.rend())) {
+    return std::nullopt;
+  }
+  return MemoryLayout::tiled(std::move(minorToMajor));
+}
+
+} // namespace
+
+Client::Client(const Context &context) : Client(context, {}) {}
+
+Client::Client(const Context &context, const std::vector<ClientCreateOption> &createOptions) : context_(context) {
+  // The named values point into `createOptions`, which outlives the call below.
+  std::vector<PJRT_NamedValue> namedValues(createOptions.size());
+  for (size_t i = 0; i < createOptions.size(); ++i) {
+    PJRT_NamedValue &namedValue = namedValues[i];
+    namedValue.struct_size = PJRT_NamedValue_STRUCT_SIZE;
+    namedValue.extension_start = nullptr;
+    namedValue.name = createOptions[i].name.data();
+    namedValue.name_size = createOptions[i].name.size();
+    namedValue.value_size = 1;
+    const auto &value = createOptions[i].value;
+    if (const std::string *stringValue = std::get_if<std::string>(&value)) {
+      namedValue.type = PJRT_NamedValue_kString;
+      namedValue.string_value = stringValue->data();
+      namedValue.value_size = stringValue->size();
+    } else if (const int64_t *intValue = std::get_if<int64_t>(&value)) {
+      namedValue.type = PJRT_NamedValue_kInt64;
+      namedValue.int64_value = *intValue;
+    } else if (const float *floatValue = std::get_if<float>(&value)) {
+      namedValue.type = PJRT_NamedValue_kFloat;
+      namedValue.float_value = *floatValue;
+    } else {
+      namedValue.type = PJRT_NamedValue_kBool;
+      namedValue.bool_value = std::get<bool>(value);
+    }
+  }
+
   PJRT_Client_Create_Args clientCreateArgs;
 
   // Initialize the struct. The PJRT_DEFINE_STRUCT_TRAITS macro in pjrt_c_api.h
   // defines e.g. PJRT_Client_Create_Args_STRUCT_SIZE which should be used.
   clientCreateArgs.struct_size = PJRT_Client_Create_Args_STRUCT_SIZE;
   clientCreateArgs.extension_start = nullptr;
-  clientCreateArgs.create_options = nullptr; // No specific options for now
-  clientCreateArgs.num_options = 0;
+  clientCreateArgs.create_options = namedValues.data();
+  clientCreateArgs.num_options = namedValues.size();
   clientCreateArgs.kv_get_callback = nullptr; // No distributed store for basic client
   clientCreateArgs.kv_get_user_arg = nullptr;
   clientCreateArgs.kv_put_callback = nullptr;
@@ -83,7 +154,20 @@ std::string Client::platformName() const {
   return std::string(platform_name_args.platform_name, platform_name_args.platform_name_size);
 }
 
-LoadedExecutable Client::compileFromStableHloString(const std::string &stableHloProgram) const {
+std::string Client::platformVersion() const {
+  PJRT_Client_PlatformVersion_Args platform_version_args;
+  platform_version_args.struct_size = PJRT_Client_PlatformVersion_Args_STRUCT_SIZE;
+  platform_version_args.extension_start = nullptr;
+  platform_version_args.client = client_;
+
+  PJRT_Error* platform_version_error = context_.pjrtApi_->PJRT_Client_PlatformVersion(&platform_version_args);
+  if (platform_version_error != nullptr) {
+    throw context_.convertPjrtErrorToException(platform_version_error, "PJRT_Client_PlatformVersion", __FILE__, __LINE__);
+  }
+  return std::string(platform_version_args.platform_version, platform_version_args.platform_version_size);
+}
+
+LoadedExecutable Client::compileFromStableHloString(const std::string &stableHloProgram, size_t numReplicas) const {
   // Use a std::vector<char> for PJRT_Program.code to be safe with the char* type
   std::vector<char> hlo_program_buffer(stableHloProgram.begin(), stableHloProgram.end());
   // TODO(PJRT): It should be made clear that a null terminator is required on the program string. 
@@ -100,18 +184,15 @@ LoadedExecutable Client::compileFromStableHloString(const std::string &stableHlo
   program_desc.format = format_str;
   program_desc.format_size = strlen(format_str);
 
-  // I manually exported the string of the device config proto.
-  const unsigned char compileOptionsData[] = { 26, 128, 7, 8, 255, 255, 255, 255, 255, 255, 255, 255, 255, 1, 26, 209, 6, 248, 1, 3, 152, 2, 1, 224, 3, 1, 234, 3, 93, 47, 117, 115, 114, 47, 108, 111, 99, 97, 108, 47, 103, 111, 111, 103, 108, 101, 47, 104, 111, 109, 101, 47, 118, 105, 99, 116, 111, 114, 115, 116, 111, 110, 101, 47, 99, 112, 112, 120, 108, 97, 47, 46, 118, 101, 110, 118, 47, 108, 105, 98, 47, 112, 121, 116, 104, 111, 110, 51, 46, 49, 51, 47, 115, 105, 116, 101, 45, 112, 97, 99, 107, 97, 103, 101, 115, 47, 110, 118, 105, 100, 105, 97, 47, 99, 117, 100, 97, 95, 110, 118, 99, 99, 176, 4, 1, 184, 4, 1, 192, 4, 1, 200, 4, 0, 136, 6, 0, 152, 6, 0, 160, 6, 0, 176, 6, 1, 160, 7, 0, 192, 7, 1, 200, 7, 1, 208, 7, 1, 216, 7, 4, 240, 7, 1, 136, 8, 1, 152, 8, 0, 160, 8, 255, 255, 255, 255, 255, 255, 255, 255, 255, 1, 200, 8, 0, 208, 8, 0, 224, 8, 0, 240, 8, 255, 255, 255, 255, 255, 255, 255, 255, 255, 1, 128, 9, 0, 168, 9, 0, 224, 9, 1, 232, 9, 135, 128, 128, 15, 152, 10, 255, 255, 255, 255, 255, 255, 255, 255, 255, 1, 160, 10, 1, 168, 10, 1, 176, 10, 0, 208, 10, 1, 168, 11, 0, 176, 11, 0, 200, 11, 1, 208, 11, 0, 216, 11, 0, 224, 11, 1, 232, 11, 1, 240, 11, 1, 216, 12, 0, 232, 12, 1, 128, 13, 5, 136, 13, 1, 146, 13, 0, 160, 13, 135, 128, 128, 15, 168, 13, 135, 128, 128, 15, 192, 13, 1, 200, 13, 0, 216, 13, 0, 128, 14, 0, 141, 14, 205, 204, 140, 63, 152, 14, 0, 160, 14, 128, 128, 128, 4, 184, 14, 1, 216, 14, 0, 224, 14, 0, 232, 14, 255, 255, 255, 255, 255, 255, 255, 255, 127, 128, 15, 0, 136, 15, 1, 152, 15, 1, 176, 15, 0, 184, 15, 1, 192, 15, 0, 208, 15, 1, 216, 15, 15, 224, 15, 0, 232, 15, 1, 240, 15, 0, 248, 15, 0, 128, 16, 0, 136, 16, 0, 146, 16, 5, 1, 2, 8, 7, 3, 152, 16, 1, 160, 16, 95, 170, 16, 0, 176, 16, 0, 200, 16, 160, 141, 6, 216, 16, 0, 224, 16, 0, 232, 16, 0, 128, 17, 1, 136, 17, 0, 144, 17, 0, 168, 17, 0, 192, 17, 1, 216, 17, 100, 224, 17, 0, 232, 17, 0, 248, 17, 0, 128, 18, 0, 144, 18, 0, 152, 18, 0, 168, 18, 16, 176, 18, 3, 192, 18, 0, 224, 18, 1, 232, 18, 0, 128, 19, 1, 136, 19, 0, 152, 19, 1, 160, 19, 128, 2, 178, 19, 0, 184, 19, 16, 192, 19, 0, 216, 19, 0, 229, 19, 205, 204, 204, 61, 232, 19, 0, 240, 19, 5, 152, 20, 32, 160, 20, 1, 184, 20, 10, 192, 20, 30, 200, 20, 0, 208, 20, 0, 216, 20, 32, 234, 20, 0, 240, 20, 0, 248, 20, 0, 128, 21, 1, 136, 21, 0, 152, 21, 255, 255, 255, 255, 255, 255, 255, 255, 255, 1, 160, 21, 0, 168, 21, 1, 176, 21, 1, 184, 21, 0, 192, 21, 0, 200, 21, 0, 216, 21, 0, 224, 21, 0, 232, 21, 0, 240, 21, 0, 248, 21, 0, 136, 22, 0, 144, 22, 0, 152, 22, 0, 160, 22, 1, 170, 22, 19, 10, 13, 99, 104, 117, 110, 107, 95, 112, 114, 101, 112, 95, 117, 115, 18, 2, 45, 49, 170, 22, 22, 10, 16, 99, 104, 117, 110, 107, 95, 115, 105, 122, 101, 95, 98, 121, 116, 101, 115, 18, 2, 45, 49, 170, 22, 19, 10, 13, 103, 112, 117, 115, 95, 112, 101, 114, 95, 110, 111, 100, 101, 18, 2, 45, 49, 170, 22, 23, 10, 17, 110, 99, 99, 108, 95, 111, 112, 95, 108, 97, 117, 110, 99, 104, 95, 117, 115, 18, 2, 45, 49, 170, 22, 20, 10, 14, 110, 105, 99, 95, 115, 112, 101, 101, 100, 95, 103, 98, 112, 115, 18, 2, 45, 49, 170, 22, 12, 10, 6, 114, 116, 116, 95, 117, 115, 18, 2, 45, 49, 176, 22, 0, 184, 22, 1, 208, 22, 1, 216, 22, 0, 232, 22, 0, 240, 22, 1, 128, 23, 0, 144, 23, 0, 160, 23, 0, 176, 23, 0, 184, 23, 1, 192, 23, 1, 202, 23, 0, 208, 23, 135, 128, 128, 15, 216, 23, 0, 224, 23, 0, 232, 23, 1, 240, 23, 1, 250, 23, 0, 128, 24, 0, 144, 24, 0, 152, 24, 0, 160, 24, 0, 176, 24, 1, 184, 24, 20, 192, 24, 40, 200, 24, 0, 208, 24, 1, 216, 24, 0, 224, 24, 0, 242, 24, 1, 1, 152, 25, 0, 160, 25, 2, 176, 25, 0, 186, 25, 0, 192, 25, 0, 208, 25, 0, 216, 25, 0, 224, 25, 0, 232, 25, 0, 136, 26, 40, 144, 26, 20, 152, 26, 0, 168, 26, 0, 32, 1, 40, 1, 48, 1, 74, 9, 8, 1, 16, 1, 26, 3, 10, 1, 0, 98, 1, 0, 146, 1, 1, 0, 152, 1, 1, 184, 1, 1, 200, 1, 29, 40, 255, 255, 255, 255, 255, 255, 255, 255, 255, 1 };
-  const int compileOptionsSize = sizeof(compileOptionsData) / sizeof(compileOptionsData[0]);
-  const char* compileOptions = reinterpret_cast<const char*>(compileOptionsData);
+  const std::string compileOptions = detail::serializedCompileOptions(numReplicas);
 
   PJRT_Client_Compile_Args compile_args;
   compile_args.struct_size = PJRT_Client_Compile_Args_STRUCT_SIZE;
   compile_args.extension_start = nullptr;
   compile_args.client = client_;
   compile_args.program = &program_desc;
-  compile_args.compile_options = compileOptions; // No specific compile options for now
-  compile_args.compile_options_size = compileOptionsSize;
+  compile_args.compile_options = compileOptions.data();
+  compile_args.compile_options_size = compileOptions.size();
   // compile_args.executable will be populated
 
   PJRT_Error* compile_error = context_.pjrtApi_->PJRT_Client_Compile(&compile_args);
@@ -128,6 +209,27 @@ LoadedExecutable Client::compileFromStableHloString(const std::string &stableHlo
   return LoadedExecutable(context_, compiledExecutable);
 }
 
+LoadedExecutable Client::deserializeAndLoad(const std::string &serializedExecutable) const {
+  PJRT_Executable_DeserializeAndLoad_Args deserialize_args;
+  deserialize_args.struct_size = PJRT_Executable_DeserializeAndLoad_Args_STRUCT_SIZE;
+  deserialize_args.extension_start = nullptr;
+  deserialize_args.client = client_;
+  deserialize_args.serialized_executable = serializedExecutable.data();
+  deserialize_args.serialized_executable_size = serializedExecutable.size();
+  // Use the compile options stored with the executable.
+  deserialize_args.overridden_serialized_compile_options = nullptr;
+  deserialize_args.overridden_serialized_compile_options_size = 0;
+
+  PJRT_Error* deserialize_error = context_.pjrtApi_->PJRT_Executable_DeserializeAndLoad(&deserialize_args);
+  if (deserialize_error != nullptr) {
+    throw context_.convertPjrtErrorToException(deserialize_error, "PJRT_Executable_DeserializeAndLoad", __FILE__, __LINE__);
+  }
+  if (deserialize_args.loaded_executable == nullptr) {
+    throw pjrt::Exception("PJRT_Executable_DeserializeAndLoad reported success, but the executable pointer is null.");
+  }
+  return LoadedExecutable(context_, deserialize_args.loaded_executable);
+}
+
 size_t Client::getNumDevices() const {
   PJRT_Client_AddressableDevices_Args addressableDevicesArgs;
   getAddressableDevices(addressableDevicesArgs);
@@ -148,6 +250,124 @@ DeviceView Client::getDevice(size_t deviceNumber) const {
   return DeviceView(context_, addressableDevicesArgs.addressable_devices[deviceNumber]);
 }
 
+std::vector<DeviceView> Client::getDevices(size_t count) const {
+  PJRT_Client_AddressableDevices_Args addressableDevicesArgs;
+  getAddressableDevices(addressableDevicesArgs);
+
+  if (count > addressableDevicesArgs.num_addressable_devices) {
+    throw pjrt::Exception("Asked for " + std::to_string(count) + " devices, but only " + std::to_string(addressableDevicesArgs.num_addressable_devices) + " are addressable.");
+  }
+  std::vector<DeviceView> devices;
+  devices.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    devices.emplace_back(context_, addressableDevicesArgs.addressable_devices[i]);
+  }
+  return devices;
+}
+
+Buffer Client::allocate(const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device) const {
+  return createUninitializedBuffer(shape, type, device.device_, nullptr);
+}
+
+Buffer Client::allocate(const Shape &shape, PJRT_Buffer_Type type, const MemoryView &memory) const {
+  return createUninitializedBuffer(shape, type, nullptr, memory.memory_);
+}
+
+Buffer Client::createUninitializedBuffer(const Shape &shape, PJRT_Buffer_Type type, PJRT_Device *device, PJRT_Memory *memory) const {
+  PJRT_Client_CreateUninitializedBuffer_Args args;
+  args.struct_size = PJRT_Client_CreateUninitializedBuffer_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.client = client_;
+  args.shape_dims = shape.data();
+  args.shape_num_dims = shape.size();
+  args.shape_element_type = type;
+  args.shape_layout = nullptr; // Use default layout
+  args.device = device;
+  args.memory = memory; // If null, allocate in the device's default memory
+  // args.buffer will be populated.
+
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Client_CreateUninitializedBuffer(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Client_CreateUninitializedBuffer", __FILE__, __LINE__);
+  }
+  return Buffer(context_, args.buffer, shape);
+}
+
+Buffer Client::fromDLPack(DLManagedTensor *managedTensor) const {
+  const DLTensor &tensor = managedTensor->dl_tensor;
+  const PJRT_Buffer_Type type = detail::fromDLDataType(tensor.dtype);
+  std::vector<int64_t> dims(tensor.shape, tensor.shape + tensor.ndim);
+
+  std::optional<MemoryLayout> layout;
+  if (tensor.strides != nullptr) {
+    layout = layoutFromDLPackStrides(dims, tensor.strides);
+  }
+  PJRT_Buffer_MemoryLayout cLayout;
+  if (layout) {
+    cLayout = layout->c_layout();
+  }
+
+  // Find the addressable device which holds the memory.
+  PJRT_Client_AddressableDevices_Args addressableDevicesArgs;
+  getAddressableDevices(addressableDevicesArgs);
+  PJRT_Device *device = nullptr;
+  if (tensor.device.device_type == kDLCPU) {
+    if (addressableDevicesArgs.num_addressable_devices > 0) {
+      device = addressableDevicesArgs.addressable_devices[0];
+    }
+  } else {
+    for (size_t i = 0; i < addressableDevicesArgs.num_addressable_devices; ++i) {
+      if (DeviceView(context_, addressableDevicesArgs.addressable_devices[i]).localHardwareId() == tensor.device.device_id) {
+        device = addressableDevicesArgs.addressable_devices[i];
+        break;
+      }
+    }
+  }
+  if (device == nullptr) {
+    throw pjrt::Exception("No addressable device matches the DLPack tensor's device.");
+  }
+
+  PJRT_Client_CreateViewOfDeviceBuffer_Args args;
+  args.struct_size = PJRT_Client_CreateViewOfDeviceBuffer_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.client = client_;
+  args.device_buffer_ptr = static_cast<char*>(tensor.data) + tensor.byte_offset;
+  args.dims = dims.data();
+  args.num_dims = dims.size();
+  args.element_type = type;
+  args.layout = (layout ? &cLayout : nullptr); // Null means the default major-to-minor layout
+  args.device = device;
+  args.on_delete_callback = &dlpackViewDeleted;
+  args.on_delete_callback_arg = managedTensor;
+  args.stream = 0;
+  args.memory = nullptr;
+  // args.buffer will be populated.
+
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Client_CreateViewOfDeviceBuffer(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Client_CreateViewOfDeviceBuffer", __FILE__, __LINE__);
+  }
+  return Buffer(context_, args.buffer, dims);
+}
+
+std::vector<MemoryView> Client::getAddressableMemories() const {
+  PJRT_Client_AddressableMemories_Args args;
+  args.struct_size = PJRT_Client_AddressableMemories_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.client = client_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Client_AddressableMemories(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Client_AddressableMemories", __FILE__, __LINE__);
+  }
+
+  std::vector<MemoryView> memories;
+  memories.reserve(args.num_addressable_memories);
+  for (size_t i = 0; i < args.num_addressable_memories; ++i) {
+    memories.emplace_back(context_, args.addressable_memories[i]);
+  }
+  return memories;
+}
+
 void Client::getAddressableDevices(PJRT_Client_AddressableDevices_Args &addressableDevicesArgs) const {
   addressableDevicesArgs.struct_size = PJRT_Client_AddressableDevices_Args_STRUCT_SIZE;
   addressableDevicesArgs.extension_start = nullptr;
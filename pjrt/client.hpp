@@ -6,6 +6,8 @@
 #include "detail/types.hpp"
 #include "deviceView.hpp"
 #include "loadedExecutable.hpp"
+#include "memoryView.hpp"
+#include "shape.hpp"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -19,33 +21,81 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <cstdint>
 #include <future>
 #include <string>
+#include <variant>
 #include <vector>
 
+struct DLManagedTensor;
 struct PJRT_Client;
 
 namespace pjrt {
 
 class Context;
 
+// A plugin-specific option for creating a client, e.g. {"cpu_device_count", int64_t{4}} to have the CPU plugin expose four devices.
+struct ClientCreateOption {
+  std::string name;
+  std::variant<std::string, int64_t, float, bool> value;
+};
+
 class Client {
 public:
   Client(const Context &context);
+  Client(const Context &context, const std::vector<ClientCreateOption> &createOptions);
   ~Client();
 
   void destroy();
 
   std::string platformName() const;
-
-  LoadedExecutable compileFromStableHloString(const std::string &stableHloProgram) const;
+  // Platform-specific version information, e.g. the CUDA version on GPU.
+  std::string platformVersion() const;
+
+  // With `numReplicas` greater than one, the program runs as that many replicas, one per device, and is launched on all of
+  // them at once, e.g. with ShardedArray arguments.
+  LoadedExecutable compileFromStableHloString(const std::string &stableHloProgram, size_t numReplicas = 1) const;
+  // Loads an executable from the output of LoadedExecutable::serialize(), skipping compilation. PJRT reports an error if
+  // it was serialized by a different platform or plugin version.
+  LoadedExecutable deserializeAndLoad(const std::string &serializedExecutable) const;
   size_t getNumDevices() const;
   DeviceView getDevice(size_t deviceNumber) const;
+  // The first `count` devices, in device number order.
+  std::vector<DeviceView> getDevices(size_t count) const;
+
+  // Returns every memory space addressable by this client, across all devices.
+  std::vector<MemoryView> getAddressableMemories() const;
 
   // Asynchronously transfers given data to the specified device.
   // `shape` must stay alive until the future is ready.
   template <typename T>
-  std::future<Buffer> transferToDevice(T *data, const std::vector<int64_t> &shape, const DeviceView &device) const;
+  std::future<Buffer> transferToDevice(T *data, const Shape &shape, const DeviceView &device) const;
+
+  // Like the above, but reads `data` with the given strides in bytes, one per dimension. This uploads e.g. a slice of a larger
+  // row-major array without packing it on the host first. `data` must stay alive until the future is ready.
+  template <typename T>
+  std::future<Buffer> transferToDevice(T *data, const Shape &shape, const std::vector<int64_t> &byteStrides, const DeviceView &device) const;
+
+  // Allocates a buffer on the specified device without transferring any data, for scratch space, accumulators or donation targets.
+  // The contents are unspecified until written, e.g. by an execution.
+  Buffer allocate(const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device) const;
+  Buffer allocate(const Shape &shape, PJRT_Buffer_Type type, const MemoryView &memory) const;
+
+  template <typename T>
+  Buffer allocate(const Shape &shape, const DeviceView &device) const {
+    return allocate(shape, detail::TypeToPjrtBufferType<T>(), device);
+  }
+
+  // Wraps memory exported by another library through DLPack as a Buffer, without copying.
+  // On success, the Buffer takes ownership of `managedTensor` and calls its deleter once PJRT no longer uses the memory.
+  // If this throws, ownership stays with the caller. The data must be ready before the Buffer is used.
+  // Tensors must be dense (in any dimension order).
+  Buffer fromDLPack(DLManagedTensor *managedTensor) const;
+
+  // Asynchronously transfers given data into the specified memory space, e.g. a device's "pinned_host" memory.
+  // `shape` must stay alive until the future is ready.
+  template <typename T>
+  std::future<Buffer> transferToMemory(T *data, const Shape &shape, const MemoryView &memory) const;
 public:
 // private:
   const Context &context_;
@@ -53,10 +103,33 @@ public:
 
 private:
   void getAddressableDevices(PJRT_Client_AddressableDevices_Args &addressableDevicesArgs) const;
+
+  // Exactly one of `device` or `memory` is expected to be non-null.
+  Buffer createUninitializedBuffer(const Shape &shape, PJRT_Buffer_Type type, PJRT_Device *device, PJRT_Memory *memory) const;
+
+  // Exactly one of `device` or `memory` is expected to be non-null.
+  // Null `byteStrides` means a dense row-major array.
+  template <typename T>
+  std::future<Buffer> transferFromHost(T *data, const Shape &shape, PJRT_Device *device, PJRT_Memory *memory, const std::vector<int64_t> *byteStrides = nullptr) const;
 };
 
 template <typename T>
-std::future<Buffer> Client::transferToDevice(T *data, const std::vector<int64_t> &shape, const DeviceView &device) const {
+std::future<Buffer> Client::transferToDevice(T *data, const Shape &shape, const DeviceView &device) const {
+  return transferFromHost(data, shape, device.device_, nullptr);
+}
+
+template <typename T>
+std::future<Buffer> Client::transferToDevice(T *data, const Shape &shape, const std::vector<int64_t> &byteStrides, const DeviceView &device) const {
+  return transferFromHost(data, shape, device.device_, nullptr, &byteStrides);
+}
+
+template <typename T>
+std::future<Buffer> Client::transferToMemory(T *data, const Shape &shape, const MemoryView &memory) const {
+  return transferFromHost(data, shape, nullptr, memory.memory_);
+}
+
+template <typename T>
+std::future<Buffer> Client::transferFromHost(T *data, const Shape &shape, PJRT_Device *device, PJRT_Memory *memory, const std::vector<int64_t> *byteStrides) const {
   // Create Input Buffer from Host Data
   PJRT_Client_BufferFromHostBuffer_Args bfhh_args;
   bfhh_args.struct_size = PJRT_Client_BufferFromHostBuffer_Args_STRUCT_SIZE;
@@ -73,11 +146,16 @@ std::future<Buffer> Client::transferToDevice(T *data, const std::vector<int64_t>
     bfhh_args.num_dims = shape.size();
   }
 
-  bfhh_args.byte_strides = nullptr; // Dense layout
-  bfhh_args.num_byte_strides = 0;
+  if (byteStrides != nullptr) {
+    bfhh_args.byte_strides = byteStrides->data();
+    bfhh_args.num_byte_strides = byteStrides->size();
+  } else {
+    bfhh_args.byte_strides = nullptr; // Dense layout
+    bfhh_args.num_byte_strides = 0;
+  }
   bfhh_args.host_buffer_semantics = PJRT_HostBufferSemantics_kImmutableUntilTransferCompletes;
-  bfhh_args.device = device.device_;
-  bfhh_args.memory = nullptr; // Use device's default memory
+  bfhh_args.device = device;
+  bfhh_args.memory = memory; // If null, use device's default memory
   bfhh_args.device_layout = nullptr; // Use default layout
 
   // These fields will be populated by the API call
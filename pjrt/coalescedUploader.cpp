@@ -0,0 +1,126 @@
+#include "coalescedUploader.hpp"
+#include "client.hpp"
+#include "deviceView.hpp"
+#include "detail/stableHloText.hpp"
+#include "exception.hpp"
+#include "hostPacker.hpp"
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace pjrt {
+
+CoalescedUploader::CoalescedUploader(const Client &client, const DeviceView &device, HostPacker *packer) : client_(client), device_(device), packer_(packer) {}
+
+size_t CoalescedUploader::add(const void *data, const Shape &shape, PJRT_Buffer_Type type) {
+  const size_t elementSize = detail::byteSizeOf(type);
+  if (elementSize == 0 || type == PJRT_Buffer_Type_PRED || type == PJRT_Buffer_Type_C64 || type == PJRT_Buffer_Type_C128) {
+    throw pjrt::Exception("CoalescedUploader only supports integer and floating point tensors.");
+  }
+  size_t numElements = 1;
+  for (int64_t dim : shape) {
+    numElements *= dim;
+  }
+
+  // Keep every tensor aligned to its element size within the block.
+  const size_t offset = (staging_.size() + elementSize - 1) / elementSize * elementSize;
+  const size_t sizeInBytes = numElements * elementSize;
+  staging_.resize(offset + sizeInBytes);
+  if (packer_ != nullptr) {
+    packer_->copy(staging_.data() + offset, data, sizeInBytes);
+  } else if (sizeInBytes > 0) {
+    std::memcpy(staging_.data() + offset, data, sizeInBytes);
+  }
+  tensors_.push_back(StagedTensor{shape, type, offset, sizeInBytes});
+  return tensors_.size() - 1;
+}
+
+std::future<std::vector<Buffer>> CoalescedUploader::upload() {
+  BatchStats stats;
+  stats.tensors = tensors_.size();
+  stats.stagingBytes = staging_.size();
+  stats.transfersSaved = (tensors_.empty() ? 0 : tensors_.size() - 1);
+
+  if (tensors_.empty()) {
+    lastBatchStats_ = stats;
+    std::promise<std::vector<Buffer>> promise;
+    promise.set_value({});
+    return promise.get_future();
+  }
+
+  const std::string signature = batchSignature();
+  auto program = programs_.find(signature);
+  stats.programCacheHit = (program != programs_.end());
+  if (!stats.programCacheHit) {
+    program = programs_.emplace(signature, client_.compileFromStableHloString(generateSlicingProgram())).first;
+  }
+
+  // One transfer for the whole batch. Waiting for it lets the staging block be reused by the next batch.
+  const std::vector<int64_t> stagingShape = {static_cast<int64_t>(staging_.size())};
+  Buffer staging = client_.transferToDevice(staging_.data(), stagingShape, device_).get();
+
+  staging_.clear();
+  tensors_.clear();
+  lastBatchStats_ = stats;
+
+  // PJRT keeps the staging memory alive until the execution which reads it has completed.
+  std::vector<Buffer*> arguments = {&staging};
+  return program->second.execute(device_, arguments);
+}
+
+std::string CoalescedUploader::batchSignature() const {
+  // Offsets follow from the types and shapes, so they need not be part of the signature.
+  std::string signature;
+  for (const StagedTensor &tensor : tensors_) {
+    signature += detail::mlirTensorType(tensor.shape, tensor.type);
+    signature += ';';
+  }
+  return signature;
+}
+
+std::string CoalescedUploader::generateSlicingProgram() const {
+  const std::string stagingType = detail::mlirTensorType({static_cast<int64_t>(staging_.size())}, PJRT_Buffer_Type_U8);
+
+  std::string resultTypes;
+  std::string body;
+  std::string returnValues;
+  for (size_t i = 0; i < tensors_.size(); ++i) {
+    const StagedTensor &tensor = tensors_[i];
+    const std::string index = std::to_string(i);
+    const std::string resultType = detail::mlirTensorType(tensor.shape, tensor.type);
+    const size_t elementSize = detail::byteSizeOf(tensor.type);
+
+    // Slice out the tensor's bytes.
+    const std::string bytesType = detail::mlirTensorType({static_cast<int64_t>(tensor.sizeInBytes)}, PJRT_Buffer_Type_U8);
+    body += "    %bytes" + index + " = \"stablehlo.slice\"(%staging) {start_indices = " +
+            detail::mlirI64Array({static_cast<int64_t>(tensor.offset)}) + ", limit_indices = " +
+            detail::mlirI64Array({static_cast<int64_t>(tensor.offset + tensor.sizeInBytes)}) + ", strides = " +
+            detail::mlirI64Array({1}) + "} : (" + stagingType + ") -> " + bytesType + "\n";
+
+    // Reinterpret the bytes as the tensor's elements. bitcast_convert to a wider type consumes a trailing dimension of bytes.
+    Shape bytesShape = tensor.shape;
+    if (elementSize > 1) {
+      bytesShape.push_back(static_cast<int64_t>(elementSize));
+    }
+    const std::string shapedBytesType = detail::mlirTensorType(bytesShape, PJRT_Buffer_Type_U8);
+    body += "    %shaped" + index + " = stablehlo.reshape %bytes" + index + " : (" + bytesType + ") -> " + shapedBytesType + "\n";
+    std::string value = "%shaped" + index;
+    if (tensor.type != PJRT_Buffer_Type_U8) {
+      body += "    %result" + index + " = stablehlo.bitcast_convert %shaped" + index + " : (" + shapedBytesType + ") -> " + resultType + "\n";
+      value = "%result" + index;
+    }
+
+    resultTypes += (i == 0 ? "" : ", ") + resultType;
+    returnValues += (i == 0 ? "" : ", ") + value;
+  }
+
+  return "module @coalesced_upload attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {\n"
+         "  func.func public @main(%staging: " + stagingType + ") -> (" + resultTypes + ") {\n" +
+         body +
+         "    return " + returnValues + " : " + resultTypes + "\n"
+         "  }\n"
+         "}"; // XLA fails to parse programs which end in a newline.
+}
+
+} // namespace pjrt
@@ -0,0 +1,98 @@
+#ifndef PJRT_COALESCED_UPLOADER_HPP_
+#define PJRT_COALESCED_UPLOADER_HPP_
+
+#include "buffer.hpp"
+#include "detail/types.hpp"
+#include "loadedExecutable.hpp"
+#include "shape.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pjrt {
+
+class Client;
+class DeviceView;
+class HostPacker;
+
+// Uploads many small host tensors to a device with a single host-to-device transfer.
+//
+// Tensors are copied into one host staging block as they are added. upload() transfers the block as a single u8 buffer and
+// splits it into the individual buffers on the device, using a slicing program which is generated for the batch's signature
+// (the element types and shapes, in order) and compiled once per signature.
+//
+// `client`, `device` and `packer` (if given) must outlive the uploader. Not thread-safe.
+class CoalescedUploader {
+public:
+  struct BatchStats {
+    size_t tensors{0};
+    // Size of the single transfer, including padding between tensors.
+    size_t stagingBytes{0};
+    // Number of host-to-device transfers avoided compared to transferring each tensor on its own.
+    size_t transfersSaved{0};
+    // Whether the slicing program for this batch was already compiled.
+    bool programCacheHit{false};
+  };
+
+  // If `packer` is given, it is used to copy large tensors into the staging block.
+  CoalescedUploader(const Client &client, const DeviceView &device, HostPacker *packer = nullptr);
+
+  // Copies a tensor into the staging block and returns its index in the batch. `data` may be reused as soon as this returns.
+  size_t add(const void *data, const Shape &shape, PJRT_Buffer_Type type);
+
+  template <typename T>
+  size_t add(const T *data, const Shape &shape) {
+    return add(static_cast<const void*>(data), shape, detail::TypeToPjrtBufferType<T>());
+  }
+
+  // Number of tensors added since the last upload().
+  size_t size() const { return tensors_.size(); }
+
+  // Transfers every added tensor and clears the batch. The returned buffers are in the order the tensors were added.
+  // Returns once the staging block has been transferred; the future is ready when the buffers have been split out on the device.
+  std::future<std::vector<Buffer>> upload();
+
+  // Statistics of the most recent upload().
+  const BatchStats& lastBatchStats() const { return lastBatchStats_; }
+
+  // Number of distinct batch signatures compiled so far.
+  size_t numCachedPrograms() const { return programs_.size(); }
+private:
+  struct StagedTensor {
+    Shape shape;
+    PJRT_Buffer_Type type;
+    size_t offset;
+    size_t sizeInBytes;
+  };
+
+  std::string batchSignature() const;
+  std::string generateSlicingProgram() const;
+
+  const Client &client_;
+  const DeviceView &device_;
+  HostPacker *packer_;
+  std::vector<uint8_t> staging_;
+  std::vector<StagedTensor> tensors_;
+  std::unordered_map<std::string, LoadedExecutable> programs_;
+  BatchStats lastBatchStats_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_COALESCED_UPLOADER_HPP_
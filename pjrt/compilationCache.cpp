@@ -0,0 +1,273 @@
+#include "compilationCache.hpp"
+#include "client.hpp"
+#include "context.hpp"
+#include "detail/compileOptions.hpp"
+#include "detail/hash.hpp"
+#include "exception.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace pjrt {
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr char kEntryExtension[] = ".pjrtexe";
+constexpr char kTemporaryExtension[] = ".tmp";
+// Identifies the entry format. Bump it when the header or the key hashes change.
+constexpr char kMagic[8] = {'P', 'J', 'R', 'T', 'E', 'X', 'E', '2'};
+// Offset basis of the check hash, chosen apart from the standard one which the file hash uses.
+constexpr uint64_t kCheckBasis = 0x9e3779b97f4a7c15ull;
+// The magic, then the check hash and the payload size as little-endian 64-bit words, so that an entry reads the same on
+// any host and with any version of this library.
+constexpr size_t kHeaderSize = sizeof(kMagic) + 2 * sizeof(uint64_t);
+
+void storeLittleEndian(uint64_t value, char *bytes) {
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    bytes[i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+uint64_t loadLittleEndian(const char *bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < sizeof(value); ++i) {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+  }
+  return value;
+}
+
+// Continues `hash` with `part` and then its length, so that moving bytes between consecutive parts changes the result.
+uint64_t hashPart(const std::string &part, uint64_t hash) {
+  char length[sizeof(uint64_t)];
+  storeLittleEndian(part.size(), length);
+  hash = detail::fnv1aHash(part.data(), part.size(), hash);
+  return detail::fnv1aHash(length, sizeof(length), hash);
+}
+
+std::string hexString(uint64_t value) {
+  char hex[17];
+  std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(value));
+  return hex;
+}
+
+// Distinguishes the temporary files of concurrent writers, in this process or another one.
+std::string uniqueSuffix() {
+  thread_local std::mt19937_64 generator(std::random_device{}());
+  return hexString(generator());
+}
+
+} // namespace
+
+CompilationCache::CompilationCache(const Client &client, std::filesystem::path directory, Options options)
+    : client_(client), directory_(std::move(directory)), options_(options) {
+  std::error_code error;
+  fs::create_directories(directory_, error);
+  if (error) {
+    throw pjrt::Exception("Failed to create compilation cache directory \"" + directory_.string() + "\": " + error.message());
+  }
+  pluginIdentity_ = client_.platformName() + '\0' + client_.platformVersion() + '\0' +
+                    std::to_string(client_.context_.apiMajorVersion()) + '.' + std::to_string(client_.context_.apiMinorVersion());
+}
+
+LoadedExecutable CompilationCache::compileFromStableHloString(const std::string &stableHloProgram, size_t numReplicas) {
+  const std::string compileOptions = detail::serializedCompileOptions(numReplicas);
+  const Key key = keyOf(stableHloProgram, compileOptions);
+
+  if (std::optional<std::string> serialized = read(key)) {
+    try {
+      LoadedExecutable executable = client_.deserializeAndLoad(*serialized);
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.hits;
+      return executable;
+    } catch (const std::exception &ex) {
+      // E.g. written by a plugin build which reported the same version. Replace it with a fresh entry below. Any failure
+      // counts, since the cache must never make compilation fail.
+      std::cerr << "pjrt::CompilationCache failed to load \"" << pathOf(key).string() << "\", compiling instead: \"" << ex.what() << "\"" << std::endl;
+      std::error_code error;
+      fs::remove(pathOf(key), error);
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++stats_.loadFailures;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.misses;
+  }
+  LoadedExecutable executable = client_.compileFromStableHloString(stableHloProgram, numReplicas);
+  try {
+    write(key, executable.serialize());
+  } catch (const std::exception &ex) {
+    std::cerr << "pjrt::CompilationCache failed to serialize an executable: \"" << ex.what() << "\"" << std::endl;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.writeFailures;
+  }
+  return executable;
+}
+
+CompilationCache::Stats CompilationCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+CompilationCache::Key CompilationCache::keyOf(const std::string &stableHloProgram, const std::string &compileOptions) const {
+  Key key;
+  uint64_t *hashes[] = {&key.fileHash, &key.checkHash};
+  const uint64_t bases[] = {detail::kFnv1aOffsetBasis, kCheckBasis};
+  for (size_t i = 0; i < 2; ++i) {
+    // Chaining the parts avoids concatenating a possibly large program.
+    uint64_t hash = hashPart(pluginIdentity_, bases[i]);
+    hash = hashPart(compileOptions, hash);
+    *hashes[i] = hashPart(stableHloProgram, hash);
+  }
+  return key;
+}
+
+std::filesystem::path CompilationCache::pathOf(const Key &key) const {
+  return directory_ / (hexString(key.fileHash) + kEntryExtension);
+}
+
+std::optional<std::string> CompilationCache::read(const Key &key) {
+  const fs::path path = pathOf(key);
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+
+  char header[kHeaderSize];
+  std::string payload;
+  bool valid = static_cast<bool>(file.read(header, sizeof(header))) && std::memcmp(header, kMagic, sizeof(kMagic)) == 0 &&
+               loadLittleEndian(header + sizeof(kMagic)) == key.checkHash;
+  const uint64_t payloadSize = (valid ? loadLittleEndian(header + sizeof(kMagic) + sizeof(uint64_t)) : 0);
+  if (valid) {
+    std::error_code error;
+    const uintmax_t fileSize = fs::file_size(path, error);
+    valid = !error && fileSize == sizeof(header) + payloadSize;
+  }
+  if (valid) {
+    payload.resize(payloadSize);
+    valid = static_cast<bool>(file.read(payload.data(), payload.size()));
+  }
+  file.close();
+
+  std::error_code error;
+  if (!valid) {
+    std::cerr << "pjrt::CompilationCache deleting invalid entry \"" << path.string() << "\"" << std::endl;
+    fs::remove(path, error);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.loadFailures;
+    return std::nullopt;
+  }
+  // Eviction goes by modification time, so mark the entry as recently used.
+  fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+  return payload;
+}
+
+void CompilationCache::write(const Key &key, const std::string &serializedExecutable) {
+  const fs::path path = pathOf(key);
+  const fs::path temporaryPath = directory_ / (path.filename().string() + '.' + uniqueSuffix() + kTemporaryExtension);
+
+  char header[kHeaderSize];
+  std::memcpy(header, kMagic, sizeof(kMagic));
+  storeLittleEndian(key.checkHash, header + sizeof(kMagic));
+  storeLittleEndian(serializedExecutable.size(), header + sizeof(kMagic) + sizeof(uint64_t));
+
+  bool written = false;
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    file.write(header, sizeof(header));
+    file.write(serializedExecutable.data(), serializedExecutable.size());
+    file.close();
+    written = static_cast<bool>(file);
+  }
+  std::error_code error;
+  if (written) {
+    // Atomically replaces any entry another writer put there in the meantime.
+    fs::rename(temporaryPath, path, error);
+  }
+  if (!written || error) {
+    std::cerr << "pjrt::CompilationCache failed to write \"" << path.string() << "\"" << (error ? ": " + error.message() : std::string()) << std::endl;
+    fs::remove(temporaryPath, error);
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.writeFailures;
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.writes;
+  evict(path);
+}
+
+void CompilationCache::evict(const std::filesystem::path &keep) {
+  struct Entry {
+    fs::path path;
+    uintmax_t size;
+    fs::file_time_type lastUsed;
+  };
+
+  // Temporary files of writers which crashed are deleted once they are clearly abandoned.
+  const fs::file_time_type now = fs::file_time_type::clock::now();
+  const fs::file_time_type abandonedBefore = now - std::chrono::hours(1);
+  // Entries nobody has loaded for this long are deleted even within budget, e.g. those of a plugin version no longer in use.
+  const fs::file_time_type unusedBefore = now - options_.maxUnusedAge;
+  std::vector<Entry> entries;
+  uintmax_t totalSize = 0;
+  std::error_code error;
+  for (fs::directory_iterator it(directory_, error), end; !error && it != end; it.increment(error)) {
+    std::error_code entryError;
+    if (!it->is_regular_file(entryError)) {
+      continue;
+    }
+    const fs::path &path = it->path();
+    const fs::file_time_type lastUsed = it->last_write_time(entryError);
+    if (path.extension() == kTemporaryExtension) {
+      if (!entryError && lastUsed < abandonedBefore) {
+        fs::remove(path, entryError);
+      }
+      continue;
+    }
+    const uintmax_t size = it->file_size(entryError);
+    if (path.extension() != kEntryExtension || entryError) {
+      continue;
+    }
+    if (lastUsed < unusedBefore && path != keep) {
+      if (fs::remove(path, entryError)) {
+        ++stats_.evictions;
+      }
+      continue;
+    }
+    entries.push_back(Entry{path, size, lastUsed});
+    totalSize += size;
+  }
+
+  if (totalSize <= options_.maxBytes) {
+    return;
+  }
+  std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) { return lhs.lastUsed < rhs.lastUsed; });
+  for (const Entry &entry : entries) {
+    if (totalSize <= options_.maxBytes) {
+      break;
+    }
+    if (entry.path == keep) {
+      continue;
+    }
+    // Another process may have deleted it already; either way its bytes are gone.
+    if (fs::remove(entry.path, error)) {
+      ++stats_.evictions;
+    }
+    totalSize -= entry.size;
+  }
+}
+
+} // namespace pjrt
@@ -0,0 +1,92 @@
+#ifndef PJRT_COMPILATION_CACHE_HPP_
+#define PJRT_COMPILATION_CACHE_HPP_
+
+#include "loadedExecutable.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+namespace pjrt {
+
+class Client;
+
+// Keeps compiled executables on disk, so that a restart loads them instead of compiling the same programs again.
+//
+// Entries are keyed by a hash of the program text, the compile options and the plugin's identity (platform name, platform
+// version and PJRT API version), and hold the executable as serialized by PJRT. Files are written to a temporary name and
+// renamed into place, so a reader never sees a partial file, even with several processes sharing the directory. When the
+// files exceed `maxBytes`, the least recently used ones are deleted.
+//
+// The cache never makes compilation fail: unreadable, truncated or stale entries are deleted and the program is compiled,
+// and errors writing an entry are logged. Keys are 64-bit FNV-1a hashes and headers are little-endian, so entries stay
+// valid across versions of this library and hosts. Entries which have not been loaded for `maxUnusedAge` are deleted, so
+// that those of a replaced plugin do not linger.
+//
+// `client` must outlive the cache. Thread-safe.
+class CompilationCache {
+public:
+  struct Options {
+    // Budget for the entries in the directory. The entry written last is kept even if it alone exceeds it.
+    size_t maxBytes{size_t{1} << 30};
+    // Entries unused for longer are deleted even within budget.
+    std::chrono::hours maxUnusedAge{24 * 30};
+  };
+
+  struct Stats {
+    size_t hits{0};
+    size_t misses{0};
+    // Entries which existed but could not be loaded, e.g. because the plugin was upgraded in place.
+    size_t loadFailures{0};
+    size_t writes{0};
+    size_t writeFailures{0};
+    size_t evictions{0};
+
+    double hitRate() const { return (hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses)); }
+  };
+
+  // Creates `directory` if needed. Throws if that fails.
+  CompilationCache(const Client &client, std::filesystem::path directory, Options options);
+  CompilationCache(const Client &client, std::filesystem::path directory) : CompilationCache(client, std::move(directory), Options()) {}
+
+  // Like Client::compileFromStableHloString(), but loads the executable from the cache if it was compiled before.
+  LoadedExecutable compileFromStableHloString(const std::string &stableHloProgram, size_t numReplicas = 1);
+
+  const std::filesystem::path& directory() const { return directory_; }
+
+  Stats stats() const;
+private:
+  struct Key {
+    // Names the file.
+    uint64_t fileHash;
+    // Stored in the file and compared on load, so that a collision of fileHash alone is not mistaken for a hit.
+    uint64_t checkHash;
+  };
+
+  Key keyOf(const std::string &stableHloProgram, const std::string &compileOptions) const;
+  std::filesystem::path pathOf(const Key &key) const;
+
+  // Returns the serialized executable stored for `key`, or nothing if there is no valid entry.
+  std::optional<std::string> read(const Key &key);
+  void write(const Key &key, const std::string &serializedExecutable);
+  // Deletes least recently used entries until the directory is within budget, sparing `keep`. Requires mutex_.
+  void evict(const std::filesystem::path &keep);
+
+  const Client &client_;
+  const std::filesystem::path directory_;
+  const Options options_;
+  // Platform and API versions, hashed into every key.
+  std::string pluginIdentity_;
+
+  mutable std::mutex mutex_;
+  Stats stats_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_COMPILATION_CACHE_HPP_
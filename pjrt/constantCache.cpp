@@ -0,0 +1,72 @@
+#include "constantCache.hpp"
+#include "detail/hash.hpp"
+#include "deviceView.hpp"
+
+#include <utility>
+
+namespace pjrt {
+
+ConstantCache::ConstantCache(const Client &client, size_t maxResidentBytes) : client_(client), maxResidentBytes_(maxResidentBytes) {}
+
+SharedBuffer ConstantCache::getOrUpload(const void *data, size_t sizeInBytes, const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device,
+                                        const std::function<Buffer()> &upload) {
+  Key key(detail::hashBytes(data, sizeInBytes), sizeInBytes, shape, type, device.device_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      ++stats_.hits;
+      stats_.bytesSaved += sizeInBytes;
+      lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+      return it->second.buffer;
+    }
+    ++stats_.misses;
+  }
+
+  // Upload without holding the lock. If another thread uploads the same tensor meanwhile, the first one to finish wins.
+  SharedBuffer buffer(upload());
+  const size_t onDeviceSizeInBytes = buffer->onDeviceSizeInBytes();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] = entries_.try_emplace(key, Entry{buffer, onDeviceSizeInBytes, {}});
+  if (!inserted) {
+    lru_.splice(lru_.end(), lru_, it->second.lruPosition);
+    return it->second.buffer;
+  }
+  it->second.lruPosition = lru_.insert(lru_.end(), std::move(key));
+  ++stats_.residentEntries;
+  stats_.residentBytes += onDeviceSizeInBytes;
+  evict();
+  return buffer;
+}
+
+void ConstantCache::evict() {
+  // Never evict the entry just added, even if it alone exceeds the budget.
+  while (stats_.residentBytes > maxResidentBytes_ && lru_.size() > 1) {
+    auto it = entries_.find(lru_.front());
+    stats_.residentBytes -= it->second.sizeInBytes;
+    --stats_.residentEntries;
+    ++stats_.evictions;
+    entries_.erase(it);
+    lru_.pop_front();
+  }
+}
+
+void ConstantCache::clear() {
+  std::map<Key, Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries.swap(entries_);
+    lru_.clear();
+    stats_.residentEntries = 0;
+    stats_.residentBytes = 0;
+  }
+  // `entries` releases its buffers here, outside the lock.
+}
+
+ConstantCache::Stats ConstantCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+} // namespace pjrt
@@ -0,0 +1,101 @@
+#ifndef PJRT_CONSTANT_CACHE_HPP_
+#define PJRT_CONSTANT_CACHE_HPP_
+
+#include "client.hpp"
+#include "detail/types.hpp"
+#include "shape.hpp"
+#include "sharedBuffer.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace pjrt {
+
+class DeviceView;
+
+// Uploads each distinct constant tensor, e.g. a seed, a mask or a lookup table, to a device only once.
+// Tensors are identified by their content: a 64-bit hash of the host bytes together with the byte count, shape, element type
+// and device. Two different tensors which agree on all of these would be confused; with a 64-bit hash this is not a practical
+// concern, but do not use the cache for adversarial inputs.
+//
+// Returned buffers are shared and read-only, see SharedBuffer. When the cache holds more than `maxResidentBytes`, the least
+// recently used entries are dropped; buffers still referenced elsewhere stay alive until those references are gone.
+// `client` must outlive the cache. Thread-safe.
+class ConstantCache {
+public:
+  struct Stats {
+    size_t hits{0};
+    size_t misses{0};
+    size_t evictions{0};
+    size_t residentEntries{0};
+    // On-device bytes of the entries held by the cache.
+    size_t residentBytes{0};
+    // Host bytes which hits did not need to transfer.
+    size_t bytesSaved{0};
+
+    double hitRate() const { return (hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses)); }
+  };
+
+  explicit ConstantCache(const Client &client, size_t maxResidentBytes = std::numeric_limits<size_t>::max());
+
+  // Returns a device buffer holding the dense array at `data`, uploading it only if the cache has no such buffer yet.
+  // Hashing reads every byte of `data`, so this is meant for constants, not for data which differs on every call.
+  template <typename T>
+  SharedBuffer get(const T *data, const Shape &shape, const DeviceView &device) {
+    const size_t sizeInBytes = static_cast<size_t>(shape.numElements()) * sizeof(T);
+    return getOrUpload(data, sizeInBytes, shape, detail::TypeToPjrtBufferType<T>(), device, [&]() {
+      return client_.transferToDevice(data, shape, device).get();
+    });
+  }
+
+  // Drops every entry.
+  void clear();
+
+  Stats stats() const;
+private:
+  using Key = std::tuple<uint64_t, size_t, Shape, PJRT_Buffer_Type, PJRT_Device*>;
+
+  struct Entry {
+    SharedBuffer buffer;
+    size_t sizeInBytes;
+    // Position in lru_.
+    std::list<Key>::iterator lruPosition;
+  };
+
+  SharedBuffer getOrUpload(const void *data, size_t sizeInBytes, const Shape &shape, PJRT_Buffer_Type type, const DeviceView &device,
+                           const std::function<Buffer()> &upload);
+
+  // Drops least recently used entries until the cache is within budget. Requires mutex_.
+  void evict();
+
+  const Client &client_;
+  const size_t maxResidentBytes_;
+
+  mutable std::mutex mutex_;
+  std::map<Key, Entry> entries_;
+  // Keys from least to most recently used.
+  std::list<Key> lru_;
+  Stats stats_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_CONSTANT_CACHE_HPP_
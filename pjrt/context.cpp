@@ -1,4 +1,5 @@
 #include "context.hpp"
+#include "deferredReleaseQueue.hpp"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -16,6 +17,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
 
 #ifndef PJRT_PLUGIN_PATH
@@ -111,6 +113,32 @@ int Context::apiMinorVersion() const {
   return pjrtApi_->pjrt_api_version.minor_version;
 }
 
+const PJRT_Extension_Base* Context::findExtension(PJRT_Extension_Type type) const {
+  if (pjrtApi_ == nullptr) {
+    throw std::runtime_error("Cannot find extensions without Pjrt API");
+  }
+  for (const PJRT_Extension_Base *extension = pjrtApi_->extension_start; extension != nullptr; extension = extension->next) {
+    if (extension->type == type) {
+      return extension;
+    }
+  }
+  return nullptr;
+}
+
+bool Context::deferBufferRelease(PJRT_Buffer *buffer) const {
+  // Most programs never attach a queue, so check without locking first.
+  if (deferredReleaseQueue_.load(std::memory_order_acquire) == nullptr) {
+    return false;
+  }
+  std::shared_lock<std::shared_mutex> lock(deferredReleaseMutex_);
+  DeferredReleaseQueue *queue = deferredReleaseQueue_.load(std::memory_order_relaxed);
+  if (queue == nullptr) {
+    return false;
+  }
+  queue->enqueue(buffer);
+  return true;
+}
+
 // For C++20 or newer, replace this with a function which uses std::source_location.
 Exception Context::convertPjrtErrorToException(PJRT_Error *error, std::string_view pjrtFunctionName, std::string_view file, int lineNumber) const {
   assert(((void)"Given null error", error != nullptr));
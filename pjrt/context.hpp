@@ -1,6 +1,7 @@
 #ifndef PJRT_CONTEXT_HPP_
 #define PJRT_CONTEXT_HPP_
 
+#include "pjrt/allocationTags.hpp"
 #include "pjrt/exception.hpp"
 #include "pjrt/detail/callbackUserData.hpp"
 
@@ -16,8 +17,12 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <atomic>
 #include <future>
+#include <shared_mutex>
+#include <string>
 #include <string_view>
+#include <vector>
 
 // Forward declaration.
 struct PJRT_Api;
@@ -26,6 +31,8 @@ struct PJRT_Event;
 
 namespace pjrt {
 
+class DeferredReleaseQueue;
+
 template <typename DataType>
 void eventReadyCallback(PJRT_Error *error, void *userArgment);
 
@@ -45,6 +52,15 @@ public:
   int apiMajorVersion() const;
   int apiMinorVersion() const;
 
+  // Returns the plugin's extension of the given type, or null if the plugin does not provide it.
+  const PJRT_Extension_Base* findExtension(PJRT_Extension_Type type) const;
+
+  // Returns the tag named `name`, creating it on first use. See AllocationTagScope and Buffer::setAllocationTag().
+  AllocationTag allocationTag(const std::string &name) const { return allocationTags_.tag(name); }
+
+  // Device memory currently attributed to each tag, to find out which owner a growth in memory belongs to.
+  std::vector<AllocationTagUsage> allocationTagUsage() const { return allocationTags_.snapshot(); }
+
   Exception convertPjrtErrorToException(PJRT_Error *error, std::string_view pjrtFunctionName, std::string_view file, int lineNumber) const;
 
   template <typename DataType>
@@ -74,6 +90,16 @@ public:
 // private:
   void *pluginHandle_{nullptr};
   const PJRT_Api *pjrtApi_{nullptr};
+  // When set, Buffers hand their PJRT_Buffer to this queue instead of destroying it themselves. See DeferredReleaseQueue.
+  // Read without locking only as a hint; the queue is attached, detached and used under deferredReleaseMutex_.
+  std::atomic<DeferredReleaseQueue*> deferredReleaseQueue_{nullptr};
+  // Held shared while a buffer is handed to the queue, and exclusively while the queue attaches or detaches, so the queue
+  // is never destroyed under an enqueue.
+  mutable std::shared_mutex deferredReleaseMutex_;
+
+  // Hands `buffer` to the attached DeferredReleaseQueue. Returns false, keeping ownership with the caller, if none is attached.
+  bool deferBufferRelease(PJRT_Buffer *buffer) const;
+  mutable AllocationTagRegistry allocationTags_;
 };
 
 template <typename DataType>
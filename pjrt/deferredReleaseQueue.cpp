@@ -0,0 +1,155 @@
+#include "deferredReleaseQueue.hpp"
+#include "context.hpp"
+#include "exception.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <shared_mutex>
+#include <utility>
+
+namespace pjrt {
+
+DeferredReleaseQueue::DeferredReleaseQueue(Context &context, Options options) : context_(context), options_(options) {
+  thread_ = std::thread([this]() { run(); });
+  std::unique_lock<std::shared_mutex> attachLock(context_.deferredReleaseMutex_);
+  if (context_.deferredReleaseQueue_.load(std::memory_order_relaxed) != nullptr) {
+    attachLock.unlock();
+    stop();
+    throw pjrt::Exception("A DeferredReleaseQueue is already attached to this Context.");
+  }
+  context_.deferredReleaseQueue_.store(this, std::memory_order_release);
+}
+
+DeferredReleaseQueue::~DeferredReleaseQueue() {
+  {
+    // Waits for buffers being handed over on other threads. Buffers dropped from now on are freed synchronously again.
+    std::unique_lock<std::shared_mutex> detachLock(context_.deferredReleaseMutex_);
+    context_.deferredReleaseQueue_.store(nullptr, std::memory_order_release);
+  }
+  // Nothing can be enqueued anymore, so the background thread's final drain frees every buffer.
+  stop();
+}
+
+void DeferredReleaseQueue::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wakeUp_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void DeferredReleaseQueue::enqueue(PJRT_Buffer *buffer) {
+  bool wake;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(buffer);
+    ++enqueued_;
+    stats_.queueLength = pending_.size();
+    stats_.peakQueueLength = std::max(stats_.peakQueueLength, stats_.queueLength);
+    wake = (pending_.size() == 1 || pending_.size() >= options_.batchSize);
+  }
+  // The first buffer wakes the idle background thread, which then waits at most maxDelay for the batch to fill up. The
+  // buffers in between need no wakeup.
+  if (wake) {
+    wakeUp_.notify_one();
+  }
+}
+
+void DeferredReleaseQueue::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const uint64_t target = enqueued_;
+  if (completed_ >= target) {
+    return;
+  }
+  flushRequested_ = true;
+  wakeUp_.notify_one();
+  drained_.wait(lock, [&]() { return completed_ >= target; });
+}
+
+DeferredReleaseQueue::Stats DeferredReleaseQueue::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void DeferredReleaseQueue::run() {
+  std::vector<PJRT_Buffer*> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    // Sleep without a timeout while there is nothing to free, so an idle queue costs no wakeups.
+    wakeUp_.wait(lock, [this]() { return stopping_ || flushRequested_ || !pending_.empty(); });
+    wakeUp_.wait_for(lock, options_.maxDelay, [this]() {
+      return stopping_ || flushRequested_ || pending_.size() >= options_.batchSize;
+    });
+    flushRequested_ = false;
+    if (pending_.empty()) {
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+    batch.swap(pending_);
+    stats_.queueLength = 0;
+    lock.unlock();
+    release(batch);
+    lock.lock();
+    completed_ += batch.size();
+    batch.clear();
+    drained_.notify_all();
+  }
+}
+
+void DeferredReleaseQueue::release(const std::vector<PJRT_Buffer*> &batch) {
+  uint64_t bytesFreed = 0;
+  uint64_t failures = 0;
+  for (PJRT_Buffer *buffer : batch) {
+    PJRT_Buffer_OnDeviceSizeInBytes_Args sizeArgs;
+    sizeArgs.struct_size = PJRT_Buffer_OnDeviceSizeInBytes_Args_STRUCT_SIZE;
+    sizeArgs.extension_start = nullptr;
+    sizeArgs.buffer = buffer;
+    PJRT_Error* pjrtError = context_.pjrtApi_->PJRT_Buffer_OnDeviceSizeInBytes(&sizeArgs);
+    size_t sizeInBytes = 0;
+    if (pjrtError == nullptr) {
+      sizeInBytes = sizeArgs.on_device_size_in_bytes;
+    } else {
+      // E.g. the buffer was donated. It still needs to be destroyed, it just doesn't count towards freed bytes.
+      context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_OnDeviceSizeInBytes", __FILE__, __LINE__);
+    }
+
+    PJRT_Buffer_Destroy_Args destroyArgs;
+    destroyArgs.struct_size = PJRT_Buffer_Destroy_Args_STRUCT_SIZE;
+    destroyArgs.extension_start = nullptr;
+    destroyArgs.buffer = buffer;
+    pjrtError = context_.pjrtApi_->PJRT_Buffer_Destroy(&destroyArgs);
+    if (pjrtError != nullptr) {
+      // Like Buffer's destructor, there is nobody to report this to.
+      const pjrt::Exception exception = context_.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_Destroy", __FILE__, __LINE__);
+      std::cerr << "pjrt::DeferredReleaseQueue failed to destroy PJRT_Buffer: \"" << exception.what() << "\"" << std::endl;
+      ++failures;
+    } else {
+      bytesFreed += sizeInBytes;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.buffersFreed += batch.size() - failures;
+  stats_.bytesFreed += bytesFreed;
+  stats_.failures += failures;
+  ++stats_.batches;
+}
+
+} // namespace pjrt
@@ -0,0 +1,90 @@
+#ifndef PJRT_DEFERRED_RELEASE_QUEUE_HPP_
+#define PJRT_DEFERRED_RELEASE_QUEUE_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct PJRT_Buffer;
+
+namespace pjrt {
+
+class Context;
+
+// Frees buffers in batches on a background thread instead of on the thread which drops them.
+// While a queue is attached to a Context, Buffer's destructor and move-assignment hand their PJRT_Buffer to the queue
+// rather than calling PJRT_Buffer_Destroy, so e.g. replacing every parameter buffer after a training step costs a few
+// pushes instead of one PJRT call per buffer. Buffer::destroy() is unaffected and still frees synchronously.
+//
+// Freed device memory becomes available for reuse only once the background thread gets to it. Call flush() before
+// allocations that need it back.
+//
+// The queue attaches itself on construction and detaches, after freeing every queued buffer, on destruction. Declare it
+// after the Client and before the Buffers whose destruction it should take over, so that it is destroyed after them and
+// before the Client. At most one queue may be attached to a Context at a time. Buffers may be dropped on any thread, e.g. in
+// a PJRT completion callback; destruction waits for buffers which are being handed over and frees them as well.
+class DeferredReleaseQueue {
+public:
+  struct Options {
+    // The background thread is woken as soon as this many buffers are queued.
+    size_t batchSize{64};
+    // Otherwise, queued buffers are freed at most this long after the first of them was queued. An idle queue sleeps until
+    // a buffer arrives.
+    std::chrono::milliseconds maxDelay{5};
+  };
+
+  struct Stats {
+    // Buffers queued but not yet freed.
+    size_t queueLength{0};
+    size_t peakQueueLength{0};
+    uint64_t buffersFreed{0};
+    // Sum of the on-device sizes of buffers freed successfully.
+    uint64_t bytesFreed{0};
+    uint64_t batches{0};
+    // Buffers for which PJRT_Buffer_Destroy reported an error. Their memory may have leaked.
+    uint64_t failures{0};
+  };
+
+  DeferredReleaseQueue(Context &context, Options options);
+  explicit DeferredReleaseQueue(Context &context) : DeferredReleaseQueue(context, Options()) {}
+  DeferredReleaseQueue(const DeferredReleaseQueue &) = delete;
+  DeferredReleaseQueue& operator=(const DeferredReleaseQueue &) = delete;
+  ~DeferredReleaseQueue();
+
+  // Takes ownership of `buffer`, which will be destroyed on the background thread.
+  void enqueue(PJRT_Buffer *buffer);
+
+  // Blocks until every buffer enqueued before the call has been freed.
+  void flush();
+
+  Stats stats() const;
+private:
+  void run();
+  // Stops the background thread once it has freed every queued buffer.
+  void stop();
+  // Destroys `batch` and records the outcome. Called without holding mutex_.
+  void release(const std::vector<PJRT_Buffer*> &batch);
+
+  Context &context_;
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  std::condition_variable drained_;
+  bool stopping_{false};
+  bool flushRequested_{false};
+  std::vector<PJRT_Buffer*> pending_;
+  // Number of buffers ever enqueued, and number of those freed so far. flush() waits for the latter to catch up.
+  uint64_t enqueued_{0};
+  uint64_t completed_{0};
+  Stats stats_;
+  std::thread thread_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_DEFERRED_RELEASE_QUEUE_HPP_
@@ -18,6 +18,8 @@
 #include <cassert>
 #include <future>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 namespace pjrt {
 
@@ -41,6 +43,11 @@ public:
     return data_;
   }
 
+  // Keeps `object` alive until this user data is destroyed, i.e. until after the operation has completed.
+  void keepAlive(std::shared_ptr<const void> object) {
+    keepAlive_.push_back(std::move(object));
+  }
+
   void setException(std::exception_ptr &&exceptionPtr) {
     promise_.set_exception(std::move(exceptionPtr));
   }
@@ -53,6 +60,37 @@ private:
   const Context &context_;
   std::promise<DataType> promise_;
   DataType data_;
+  std::vector<std::shared_ptr<const void>> keepAlive_;
+};
+
+// Specialization for asynchronous operations which complete without producing a value, such as copying into caller-provided memory.
+template <>
+class CallbackUserData<void> {
+public:
+  CallbackUserData(const Context &context) : context_(context) {}
+
+  const Context &getContext() const { return context_; }
+
+  std::future<void> getFuture() {
+    return promise_.get_future();
+  }
+
+  // Keeps `object` alive until this user data is destroyed, i.e. until after the operation has completed.
+  void keepAlive(std::shared_ptr<const void> object) {
+    keepAlive_.push_back(std::move(object));
+  }
+
+  void setException(std::exception_ptr &&exceptionPtr) {
+    promise_.set_exception(std::move(exceptionPtr));
+  }
+
+  void fulfill() {
+    promise_.set_value();
+  }
+private:
+  const Context &context_;
+  std::promise<void> promise_;
+  std::vector<std::shared_ptr<const void>> keepAlive_;
 };
 
 } // namespace detail
@@ -0,0 +1,15 @@
+#ifndef PJRT_DETAIL_COMPILE_OPTIONS_HPP_
+#define PJRT_DETAIL_COMPILE_OPTIONS_HPP_
+
+#include <cstddef>
+#include <string>
+
+namespace pjrt::detail {
+
+// Returns a serialized xla::CompileOptionsProto which compiles a program for `numReplicas` devices, one replica each, with
+// PJRT's default device assignment. For a single replica these are exactly the options the library has always used.
+std::string serializedCompileOptions(size_t numReplicas = 1);
+
+} // namespace pjrt::detail
+
+#endif // PJRT_DETAIL_COMPILE_OPTIONS_HPP_
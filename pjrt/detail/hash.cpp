@@ -0,0 +1,59 @@
+#include "hash.hpp"
+
+#include <cstring>
+
+namespace pjrt::detail {
+
+namespace {
+
+constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+
+// The finalizer of SplitMix64: every input bit affects every output bit.
+uint64_t mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ULL;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebULL;
+  value ^= value >> 31;
+  return value;
+}
+
+} // namespace
+
+uint64_t hashBytes(const void *data, size_t size, uint64_t seed) {
+  const unsigned char *bytes = static_cast<const unsigned char*>(data);
+  // Four independent lanes let the multiplies of consecutive words overlap.
+  uint64_t lanes[4] = {seed ^ kMultiplier, seed + kMultiplier, seed ^ (kMultiplier << 1), seed - kMultiplier};
+  size_t offset = 0;
+  for (; offset + 32 <= size; offset += 32) {
+    for (int lane = 0; lane < 4; ++lane) {
+      uint64_t word;
+      std::memcpy(&word, bytes + offset + 8 * lane, sizeof(word));
+      lanes[lane] = (lanes[lane] ^ word) * kMultiplier;
+      lanes[lane] ^= lanes[lane] >> 29;
+    }
+  }
+  uint64_t hash = mix(lanes[0]) ^ mix(lanes[1] + 1) ^ mix(lanes[2] + 2) ^ mix(lanes[3] + 3);
+  for (; offset + 8 <= size; offset += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + offset, sizeof(word));
+    hash = mix(hash ^ word);
+  }
+  if (offset < size) {
+    uint64_t tail = 0;
+    std::memcpy(&tail, bytes + offset, size - offset);
+    hash = mix(hash ^ tail);
+  }
+  // Without the length, inputs which differ only in trailing zero bytes would collide.
+  return mix(hash ^ static_cast<uint64_t>(size));
+}
+
+uint64_t fnv1aHash(const void *data, size_t size, uint64_t hash) {
+  const unsigned char *bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+} // namespace pjrt::detail
@@ -0,0 +1,22 @@
+#ifndef PJRT_DETAIL_HASH_HPP_
+#define PJRT_DETAIL_HASH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pjrt::detail {
+
+// A fast, non-cryptographic 64-bit hash of `size` bytes, for content-addressed caches. Reads eight bytes per step.
+// Not stable across library versions; do not persist the result.
+uint64_t hashBytes(const void *data, size_t size, uint64_t seed = 0);
+
+// The standard offset basis of 64-bit FNV-1a.
+constexpr uint64_t kFnv1aOffsetBasis = 0xcbf29ce484222325ULL;
+
+// 64-bit FNV-1a of `size` bytes, continuing from `hash`. Slower than hashBytes(), but specified and independent of the host's
+// byte order, so the result may be persisted, e.g. in file names. Never change it.
+uint64_t fnv1aHash(const void *data, size_t size, uint64_t hash = kFnv1aOffsetBasis);
+
+} // namespace pjrt::detail
+
+#endif // PJRT_DETAIL_HASH_HPP_
@@ -0,0 +1,56 @@
+#ifndef PJRT_DETAIL_HOST_MIRROR_HPP_
+#define PJRT_DETAIL_HOST_MIRROR_HPP_
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <memory>
+#include <mutex>
+
+namespace pjrt::detail {
+
+// The last readback of a Buffer, see Buffer::mirroredToHost(). Shared between the Buffer and any RawBuffer aliasing it, so
+// that writes through the alias can invalidate it.
+struct HostMirror {
+  std::mutex mutex;
+  // Element type of the readback. Meaningless while `readback` is null.
+  PJRT_Buffer_Type type{PJRT_Buffer_Type_INVALID};
+  // A std::shared_future<std::vector<T>> for the T matching `type`, or null if there is no valid mirror.
+  std::shared_ptr<const void> readback;
+  // Writes through a RawBuffer which have been issued but have not completed. A readback taken meanwhile may see the old
+  // bytes, so it must not be kept as the mirror.
+  int writesInFlight{0};
+
+  void invalidate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    readback.reset();
+  }
+
+  bool hasReadback() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return readback != nullptr;
+  }
+
+  // Bracket a write: the mirror is dropped on both ends, and no readback is kept in between.
+  void beginWrite() {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++writesInFlight;
+    readback.reset();
+  }
+  void endWrite() {
+    std::lock_guard<std::mutex> lock(mutex);
+    --writesInFlight;
+    readback.reset();
+  }
+};
+
+} // namespace pjrt::detail
+
+#endif // PJRT_DETAIL_HOST_MIRROR_HPP_
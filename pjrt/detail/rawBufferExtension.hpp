@@ -0,0 +1,116 @@
+#ifndef PJRT_DETAIL_RAW_BUFFER_EXTENSION_HPP_
+#define PJRT_DETAIL_RAW_BUFFER_EXTENSION_HPP_
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__has_include)
+#if __has_include("xla/pjrt/c/pjrt_c_api_raw_buffer_extension.h")
+#include "xla/pjrt/c/pjrt_c_api_raw_buffer_extension.h"
+#define PJRT_HAS_UPSTREAM_RAW_BUFFER_EXTENSION 1
+#endif
+#endif
+
+#ifndef PJRT_HAS_UPSTREAM_RAW_BUFFER_EXTENSION
+
+// Mirrors the experimental xla/pjrt/c/pjrt_c_api_raw_buffer_extension.h, which is not shipped with pjrt_c_api.h.
+// The layout must match the plugin's; RawBuffer checks the extension's struct_size before using a function.
+extern "C" {
+
+typedef struct PJRT_RawBuffer PJRT_RawBuffer;
+
+struct PJRT_RawBuffer_CreateRawAliasOfBuffer_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  PJRT_Buffer* buffer;
+  PJRT_RawBuffer* raw_buffer;  // out
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_RawBuffer_CreateRawAliasOfBuffer_Args, raw_buffer);
+typedef PJRT_Error* PJRT_RawBuffer_CreateRawAliasOfBuffer(PJRT_RawBuffer_CreateRawAliasOfBuffer_Args* args);
+
+struct PJRT_RawBuffer_Destroy_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  PJRT_RawBuffer* buffer;
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_RawBuffer_Destroy_Args, buffer);
+typedef PJRT_Error* PJRT_RawBuffer_Destroy(PJRT_RawBuffer_Destroy_Args* args);
+
+struct PJRT_RawBuffer_GetOnDeviceSizeInBytes_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  PJRT_RawBuffer* buffer;
+  size_t on_device_size_in_bytes;  // out
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_RawBuffer_GetOnDeviceSizeInBytes_Args, on_device_size_in_bytes);
+typedef PJRT_Error* PJRT_RawBuffer_GetOnDeviceSizeInBytes(PJRT_RawBuffer_GetOnDeviceSizeInBytes_Args* args);
+
+struct PJRT_RawBuffer_GetMemorySpace_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  PJRT_RawBuffer* buffer;
+  PJRT_Memory* memory_space;  // out
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_RawBuffer_GetMemorySpace_Args, memory_space);
+typedef PJRT_Error* PJRT_RawBuffer_GetMemorySpace(PJRT_RawBuffer_GetMemorySpace_Args* args);
+
+struct PJRT_RawBuffer_CopyRawHostToDevice_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  PJRT_RawBuffer* buffer;
+  const void* src;
+  int64_t offset;
+  int64_t transfer_size;
+  PJRT_Event* event;  // out
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_RawBuffer_CopyRawHostToDevice_Args, event);
+typedef PJRT_Error* PJRT_RawBuffer_CopyRawHostToDevice(PJRT_RawBuffer_CopyRawHostToDevice_Args* args);
+
+struct PJRT_RawBuffer_CopyRawDeviceToHost_Args {
+  size_t struct_size;
+  PJRT_Extension_Base* extension_start;
+  PJRT_RawBuffer* buffer;
+  void* dst;
+  int64_t offset;
+  int64_t transfer_size;
+  PJRT_Event* event;  // out
+};
+PJRT_DEFINE_STRUCT_TRAITS(PJRT_RawBuffer_CopyRawDeviceToHost_Args, event);
+typedef PJRT_Error* PJRT_RawBuffer_CopyRawDeviceToHost(PJRT_RawBuffer_CopyRawDeviceToHost_Args* args);
+
+typedef struct PJRT_RawBuffer_Extension {
+  PJRT_Extension_Base base;
+  PJRT_RawBuffer_CreateRawAliasOfBuffer* PJRT_RawBuffer_CreateRawAliasOfBuffer;
+  PJRT_RawBuffer_Destroy* PJRT_RawBuffer_Destroy;
+  PJRT_RawBuffer_GetOnDeviceSizeInBytes* PJRT_RawBuffer_GetOnDeviceSizeInBytes;
+  PJRT_RawBuffer_GetMemorySpace* PJRT_RawBuffer_GetMemorySpace;
+  PJRT_RawBuffer_CopyRawHostToDevice* PJRT_RawBuffer_CopyRawHostToDevice;
+  PJRT_RawBuffer_CopyRawDeviceToHost* PJRT_RawBuffer_CopyRawDeviceToHost;
+} PJRT_RawBuffer_Extension;
+
+} // extern "C"
+
+#endif // PJRT_HAS_UPSTREAM_RAW_BUFFER_EXTENSION
+
+// The mirrored extension struct names its fields after their function typedefs, like pjrt_c_api.h does, so it needs the
+// same diagnostic suppression.
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pjrt::detail {
+
+// The extension must provide at least every function up to and including CopyRawDeviceToHost.
+constexpr size_t kMinimumRawBufferExtensionSize = offsetof(PJRT_RawBuffer_Extension, PJRT_RawBuffer_CopyRawDeviceToHost) + sizeof(void*);
+
+} // namespace pjrt::detail
+
+#endif // PJRT_DETAIL_RAW_BUFFER_EXTENSION_HPP_
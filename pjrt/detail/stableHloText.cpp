@@ -0,0 +1,52 @@
+#include "stableHloText.hpp"
+
+#include "pjrt/exception.hpp"
+
+#include <string>
+
+namespace pjrt::detail {
+
+std::string mlirElementType(PJRT_Buffer_Type type) {
+  switch (type) {
+    case PJRT_Buffer_Type_PRED: return "i1";
+    case PJRT_Buffer_Type_S8:   return "i8";
+    case PJRT_Buffer_Type_S16:  return "i16";
+    case PJRT_Buffer_Type_S32:  return "i32";
+    case PJRT_Buffer_Type_S64:  return "i64";
+    case PJRT_Buffer_Type_U8:   return "ui8";
+    case PJRT_Buffer_Type_U16:  return "ui16";
+    case PJRT_Buffer_Type_U32:  return "ui32";
+    case PJRT_Buffer_Type_U64:  return "ui64";
+    case PJRT_Buffer_Type_F16:  return "f16";
+    case PJRT_Buffer_Type_BF16: return "bf16";
+    case PJRT_Buffer_Type_F32:  return "f32";
+    case PJRT_Buffer_Type_F64:  return "f64";
+    case PJRT_Buffer_Type_C64:  return "complex<f32>";
+    case PJRT_Buffer_Type_C128: return "complex<f64>";
+    default:
+      throw pjrt::Exception("Buffer type " + std::to_string(static_cast<int>(type)) + " has no StableHLO element type.");
+  }
+}
+
+std::string mlirTensorType(const Shape &dims, PJRT_Buffer_Type type) {
+  std::string result = "tensor<";
+  for (int64_t dim : dims) {
+    result += std::to_string(dim);
+    result += 'x';
+  }
+  result += mlirElementType(type);
+  result += '>';
+  return result;
+}
+
+std::string mlirI64Array(const std::vector<int64_t> &values) {
+  std::string result = "array<i64";
+  for (size_t i = 0; i < values.size(); ++i) {
+    result += (i == 0 ? ": " : ", ");
+    result += std::to_string(values[i]);
+  }
+  result += '>';
+  return result;
+}
+
+} // namespace pjrt::detail
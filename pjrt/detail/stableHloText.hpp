@@ -0,0 +1,36 @@
+#ifndef PJRT_DETAIL_STABLE_HLO_TEXT_HPP_
+#define PJRT_DETAIL_STABLE_HLO_TEXT_HPP_
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include "pjrt/shape.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Helpers for writing StableHLO programs as text, for the programs which the library generates itself.
+namespace pjrt::detail {
+
+// Returns the MLIR element type of `type`, e.g. "f32" or "ui8". Throws for types which have no MLIR spelling here.
+std::string mlirElementType(PJRT_Buffer_Type type);
+
+// Returns the MLIR tensor type of an array, e.g. "tensor<2x3xf32>", or "tensor<f32>" for a scalar.
+std::string mlirTensorType(const Shape &dims, PJRT_Buffer_Type type);
+
+// Returns `values` as a dense i64 array attribute, e.g. "array<i64: 0, 4>".
+std::string mlirI64Array(const std::vector<int64_t> &values);
+
+} // namespace pjrt::detail
+
+#endif // PJRT_DETAIL_STABLE_HLO_TEXT_HPP_
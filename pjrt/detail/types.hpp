@@ -13,6 +13,7 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 
@@ -47,6 +48,34 @@ constexpr PJRT_Buffer_Type TypeToPjrtBufferType() {
   return PjrtTypeFor<NonConstT>::kType;
 }
 
+// Returns the size in bytes of one element of `type`, or 0 for types which are not byte-sized (e.g. S4) or not supported.
+constexpr size_t byteSizeOf(PJRT_Buffer_Type type) {
+  switch (type) {
+    case PJRT_Buffer_Type_PRED:
+    case PJRT_Buffer_Type_S8:
+    case PJRT_Buffer_Type_U8:
+      return 1;
+    case PJRT_Buffer_Type_S16:
+    case PJRT_Buffer_Type_U16:
+    case PJRT_Buffer_Type_F16:
+    case PJRT_Buffer_Type_BF16:
+      return 2;
+    case PJRT_Buffer_Type_S32:
+    case PJRT_Buffer_Type_U32:
+    case PJRT_Buffer_Type_F32:
+      return 4;
+    case PJRT_Buffer_Type_S64:
+    case PJRT_Buffer_Type_U64:
+    case PJRT_Buffer_Type_F64:
+    case PJRT_Buffer_Type_C64:
+      return 8;
+    case PJRT_Buffer_Type_C128:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
 } // namespace pjrt::detail
 
 #endif // PJRT_TYPES_HPP_
\ No newline at end of file
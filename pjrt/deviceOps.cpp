@@ -0,0 +1,387 @@
+#include "deviceOps.hpp"
+#include "client.hpp"
+#include "context.hpp"
+#include "detail/callbackUserData.hpp"
+#include "detail/stableHloText.hpp"
+#include "deviceView.hpp"
+#include "exception.hpp"
+
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace pjrt {
+
+namespace {
+
+std::string shapeString(const Shape &shape) {
+  std::string result = "[";
+  for (size_t i = 0; i < shape.size(); ++i) {
+    result += (i == 0 ? "" : ", ") + std::to_string(shape[i]);
+  }
+  return result + "]";
+}
+
+void checkRank(const char *op, const char *what, size_t size, size_t rank) {
+  if (size != rank) {
+    throw pjrt::Exception(std::string("DeviceOps::") + op + ": " + what + " has " + std::to_string(size) + " entries for an operand of rank " + std::to_string(rank) + ".");
+  }
+}
+
+bool isInteger(PJRT_Buffer_Type type) {
+  switch (type) {
+    case PJRT_Buffer_Type_S8:
+    case PJRT_Buffer_Type_S16:
+    case PJRT_Buffer_Type_S32:
+    case PJRT_Buffer_Type_S64:
+    case PJRT_Buffer_Type_U8:
+    case PJRT_Buffer_Type_U16:
+    case PJRT_Buffer_Type_U32:
+    case PJRT_Buffer_Type_U64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Uploads a rank-0 buffer holding `value`. Blocks until the transfer no longer needs the host copy, which for a scalar is
+// about as long as issuing it.
+template <typename T>
+Buffer uploadScalar(const Client &client, const DeviceView &device, T value) {
+  const Shape scalar;
+  return client.transferToDevice(&value, scalar, device).get();
+}
+
+template <typename T>
+Buffer uploadIntegerPadding(const Client &client, const DeviceView &device, double value) {
+  // Written so that NaN fails the check as well.
+  if (!(value >= static_cast<double>(std::numeric_limits<T>::lowest()) && value <= static_cast<double>(std::numeric_limits<T>::max()) && value == std::trunc(value))) {
+    throw pjrt::Exception("DeviceOps::pad: padding value " + std::to_string(value) + " is not representable in the operand's integer type.");
+  }
+  return uploadScalar(client, device, static_cast<T>(value));
+}
+
+// Uploads `value` as a scalar the program converts to `type`. Element types without a host counterpart travel as the
+// closest one that has, which is returned in `carrierType`.
+Buffer uploadPadding(const Client &client, const DeviceView &device, double value, PJRT_Buffer_Type type, PJRT_Buffer_Type &carrierType) {
+  switch (type) {
+    case PJRT_Buffer_Type_PRED:
+      carrierType = PJRT_Buffer_Type_U8;
+      return uploadScalar<uint8_t>(client, device, (value != 0.0 ? 1 : 0));
+    case PJRT_Buffer_Type_S8:  carrierType = type; return uploadIntegerPadding<int8_t>(client, device, value);
+    case PJRT_Buffer_Type_S16: carrierType = type; return uploadIntegerPadding<int16_t>(client, device, value);
+    case PJRT_Buffer_Type_S32: carrierType = type; return uploadIntegerPadding<int32_t>(client, device, value);
+    case PJRT_Buffer_Type_S64: carrierType = type; return uploadIntegerPadding<int64_t>(client, device, value);
+    case PJRT_Buffer_Type_U8:  carrierType = type; return uploadIntegerPadding<uint8_t>(client, device, value);
+    case PJRT_Buffer_Type_U16: carrierType = type; return uploadIntegerPadding<uint16_t>(client, device, value);
+    case PJRT_Buffer_Type_U32: carrierType = type; return uploadIntegerPadding<uint32_t>(client, device, value);
+    case PJRT_Buffer_Type_U64: carrierType = type; return uploadIntegerPadding<uint64_t>(client, device, value);
+    case PJRT_Buffer_Type_F16:
+    case PJRT_Buffer_Type_BF16:
+    case PJRT_Buffer_Type_F32:
+    case PJRT_Buffer_Type_C64:
+      carrierType = PJRT_Buffer_Type_F32;
+      return uploadScalar(client, device, static_cast<float>(value));
+    case PJRT_Buffer_Type_F64:
+    case PJRT_Buffer_Type_C128:
+      carrierType = PJRT_Buffer_Type_F64;
+      return uploadScalar(client, device, value);
+    default:
+      throw pjrt::Exception("DeviceOps::pad: element type " + detail::mlirElementType(type) + " is not supported.");
+  }
+}
+
+// A module whose main function takes `operandTypes` and returns %result of `resultType`, computed by `body`.
+std::string moduleText(const std::string &name, const std::vector<std::string> &operandTypes, const std::string &resultType, const std::string &body) {
+  std::string parameters;
+  for (size_t i = 0; i < operandTypes.size(); ++i) {
+    parameters += (i == 0 ? "" : ", ") + ("%arg" + std::to_string(i) + ": ") + operandTypes[i];
+  }
+  return "module @" + name + " attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {\n"
+         "  func.func public @main(" + parameters + ") -> " + resultType + " {\n" +
+         body +
+         "    return %result : " + resultType + "\n"
+         "  }\n"
+         "}"; // XLA fails to parse programs which end in a newline.
+}
+
+} // namespace
+
+DeviceOps::DeviceOps(const Client &client, const DeviceView &device, Options options) : client_(client), device_(device), options_(options) {}
+
+Buffer DeviceOps::slice(const Buffer &input, const std::vector<int64_t> &start, const std::vector<int64_t> &limit, const std::vector<int64_t> &strides) {
+  const Shape &dims = input.dimensions();
+  const std::vector<int64_t> steps = (strides.empty() ? std::vector<int64_t>(dims.size(), 1) : strides);
+  checkRank("slice", "start", start.size(), dims.size());
+  checkRank("slice", "limit", limit.size(), dims.size());
+  checkRank("slice", "strides", steps.size(), dims.size());
+
+  std::vector<int64_t> resultDims(dims.size());
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (start[i] < 0 || start[i] > limit[i] || limit[i] > dims[i] || steps[i] < 1) {
+      throw pjrt::Exception("DeviceOps::slice: invalid bounds " + shapeString(start) + " to " + shapeString(limit) + " with strides " + shapeString(steps) + " for shape " + shapeString(dims) + ".");
+    }
+    resultDims[i] = (limit[i] - start[i] + steps[i] - 1) / steps[i];
+  }
+
+  // The window's size and strides shape the result and are compiled in. Its start is an operand, one i64 per dimension,
+  // which the program splits into the scalar start indices of stablehlo.dynamic_slice.
+  std::vector<int64_t> sizes(dims.size());
+  bool strided = false;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    sizes[i] = limit[i] - start[i];
+    strided = strided || steps[i] != 1;
+  }
+  const PJRT_Buffer_Type type = input.elementType();
+  const std::string inputType = detail::mlirTensorType(dims, type);
+  const std::string windowType = detail::mlirTensorType(sizes, type);
+  const std::string resultType = detail::mlirTensorType(resultDims, type);
+  const std::string startsType = detail::mlirTensorType({static_cast<int64_t>(dims.size())}, PJRT_Buffer_Type_S64);
+  const std::string indexType = detail::mlirTensorType({}, PJRT_Buffer_Type_S64);
+  std::vector<Buffer> uploaded;
+  std::vector<std::string> operandTypes = {inputType};
+  if (!dims.empty()) {
+    const Shape startsShape = {static_cast<int64_t>(dims.size())};
+    uploaded.push_back(client_.transferToDevice(start.data(), startsShape, device_).get());
+    operandTypes.push_back(startsType);
+  }
+  return run("slice " + inputType + " " + windowType + " strides " + detail::mlirI64Array(steps), [&]() {
+    std::string body;
+    std::string indices;
+    std::string indexTypes;
+    for (size_t i = 0; i < dims.size(); ++i) {
+      const std::string index = "%start" + std::to_string(i);
+      const int64_t position = static_cast<int64_t>(i);
+      body += "    " + index + "_1 = \"stablehlo.slice\"(%arg1) {start_indices = " + detail::mlirI64Array({position}) + ", limit_indices = " + detail::mlirI64Array({position + 1}) +
+              ", strides = array<i64: 1>} : (" + startsType + ") -> tensor<1xi64>\n"
+              "    " + index + " = stablehlo.reshape " + index + "_1 : (tensor<1xi64>) -> " + indexType + "\n";
+      indices += ", " + index;
+      indexTypes += ", " + indexType;
+    }
+    const std::string window = (strided ? "%window" : "%result");
+    body += "    " + window + " = \"stablehlo.dynamic_slice\"(%arg0" + indices + ") {slice_sizes = " + detail::mlirI64Array(sizes) + "} : (" + inputType + indexTypes + ") -> " + windowType + "\n";
+    if (strided) {
+      body += "    %result = \"stablehlo.slice\"(%window) {start_indices = " + detail::mlirI64Array(std::vector<int64_t>(dims.size(), 0)) + ", limit_indices = " + detail::mlirI64Array(sizes) +
+              ", strides = " + detail::mlirI64Array(steps) + "} : (" + windowType + ") -> " + resultType + "\n";
+    }
+    return moduleText("device_slice", operandTypes, resultType, body);
+  }, {&input}, std::move(uploaded));
+}
+
+Buffer DeviceOps::concatenate(const std::vector<const Buffer*> &inputs, size_t axis) {
+  if (inputs.empty()) {
+    throw pjrt::Exception("DeviceOps::concatenate: needs at least one operand.");
+  }
+  const Shape &firstDims = inputs[0]->dimensions();
+  const PJRT_Buffer_Type type = inputs[0]->elementType();
+  if (axis >= firstDims.size()) {
+    throw pjrt::Exception("DeviceOps::concatenate: axis " + std::to_string(axis) + " is out of range for shape " + shapeString(firstDims) + ".");
+  }
+
+  Shape resultDims = firstDims;
+  resultDims[axis] = 0;
+  std::vector<std::string> inputTypes;
+  std::string operands;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const Shape &dims = inputs[i]->dimensions();
+    bool compatible = (dims.size() == firstDims.size() && inputs[i]->elementType() == type);
+    for (size_t d = 0; compatible && d < dims.size(); ++d) {
+      compatible = (d == axis || dims[d] == firstDims[d]);
+    }
+    if (!compatible) {
+      throw pjrt::Exception("DeviceOps::concatenate: operand " + std::to_string(i) + " of shape " + shapeString(dims) + " cannot be joined to shape " + shapeString(firstDims) + " along axis " + std::to_string(axis) + ".");
+    }
+    resultDims[axis] += dims[axis];
+    inputTypes.push_back(detail::mlirTensorType(dims, type));
+    operands += (i == 0 ? "" : ", ") + ("%arg" + std::to_string(i));
+  }
+
+  const std::string resultType = detail::mlirTensorType(resultDims, type);
+  std::string signature = "concatenate " + std::to_string(axis);
+  for (const std::string &inputType : inputTypes) {
+    signature += ' ' + inputType;
+  }
+  return run(signature, [&]() {
+    std::string body = "    %result = \"stablehlo.concatenate\"(" + operands + ") {dimension = " + std::to_string(axis) + " : i64} : (";
+    for (size_t i = 0; i < inputTypes.size(); ++i) {
+      body += (i == 0 ? "" : ", ") + inputTypes[i];
+    }
+    body += ") -> " + resultType + "\n";
+    return moduleText("device_concatenate", inputTypes, resultType, body);
+  }, inputs);
+}
+
+Buffer DeviceOps::convert(const Buffer &input, PJRT_Buffer_Type type) {
+  const std::string inputType = detail::mlirTensorType(input.dimensions(), input.elementType());
+  const std::string resultType = detail::mlirTensorType(input.dimensions(), type);
+  return run("convert " + inputType + " " + resultType, [&]() {
+    return moduleText("device_convert", {inputType}, resultType,
+                      "    %result = stablehlo.convert %arg0 : (" + inputType + ") -> " + resultType + "\n");
+  }, {&input});
+}
+
+Buffer DeviceOps::reshape(const Buffer &input, const Shape &shape) {
+  if (input.dimensions().numElements() != shape.numElements()) {
+    throw pjrt::Exception("DeviceOps::reshape: cannot reshape " + shapeString(input.dimensions()) + " to " + shapeString(shape) + ".");
+  }
+
+  const PJRT_Buffer_Type type = input.elementType();
+  const std::string inputType = detail::mlirTensorType(input.dimensions(), type);
+  const std::string resultType = detail::mlirTensorType(shape, type);
+  return run("reshape " + inputType + " " + resultType, [&]() {
+    return moduleText("device_reshape", {inputType}, resultType,
+                      "    %result = stablehlo.reshape %arg0 : (" + inputType + ") -> " + resultType + "\n");
+  }, {&input});
+}
+
+Buffer DeviceOps::pad(const Buffer &input, const std::vector<int64_t> &low, const std::vector<int64_t> &high, double paddingValue, const std::vector<int64_t> &interior) {
+  const Shape &dims = input.dimensions();
+  const std::vector<int64_t> gaps = (interior.empty() ? std::vector<int64_t>(dims.size(), 0) : interior);
+  checkRank("pad", "low", low.size(), dims.size());
+  checkRank("pad", "high", high.size(), dims.size());
+  checkRank("pad", "interior", gaps.size(), dims.size());
+
+  std::vector<int64_t> resultDims(dims.size());
+  for (size_t i = 0; i < dims.size(); ++i) {
+    resultDims[i] = low[i] + high[i] + dims[i] + (dims[i] > 0 ? (dims[i] - 1) * gaps[i] : 0);
+    if (gaps[i] < 0 || resultDims[i] < 0) {
+      throw pjrt::Exception("DeviceOps::pad: invalid padding " + shapeString(low) + ", " + shapeString(high) + ", " + shapeString(gaps) + " for shape " + shapeString(dims) + ".");
+    }
+  }
+
+  const PJRT_Buffer_Type type = input.elementType();
+  // The padding value is an operand rather than a constant, so that every value shares one program.
+  PJRT_Buffer_Type carrierType = type;
+  std::vector<Buffer> uploaded;
+  uploaded.push_back(uploadPadding(client_, device_, paddingValue, type, carrierType));
+  const std::string inputType = detail::mlirTensorType(dims, type);
+  const std::string carrierScalarType = detail::mlirTensorType({}, carrierType);
+  const std::string scalarType = detail::mlirTensorType({}, type);
+  const std::string resultType = detail::mlirTensorType(resultDims, type);
+  const std::string attributes = "edge_padding_low = " + detail::mlirI64Array(low) + ", edge_padding_high = " + detail::mlirI64Array(high) + ", interior_padding = " + detail::mlirI64Array(gaps);
+  return run("pad " + inputType + " {" + attributes + "}", [&]() {
+    std::string body;
+    std::string padding = "%arg1";
+    if (carrierType != type) {
+      body += "    %padding = stablehlo.convert %arg1 : (" + carrierScalarType + ") -> " + scalarType + "\n";
+      padding = "%padding";
+    }
+    body += "    %result = \"stablehlo.pad\"(%arg0, " + padding + ") {" + attributes + "} : (" + inputType + ", " + scalarType + ") -> " + resultType + "\n";
+    return moduleText("device_pad", {inputType, carrierScalarType}, resultType, body);
+  }, {&input}, std::move(uploaded));
+}
+
+Buffer DeviceOps::gather(const Buffer &input, const Buffer &indices, size_t axis) {
+  const Shape &dims = input.dimensions();
+  const PJRT_Buffer_Type indexType = indices.elementType();
+  if (indices.dimensions().size() != 1 || !isInteger(indexType)) {
+    throw pjrt::Exception("DeviceOps::gather: indices must be a rank-1 integer buffer.");
+  }
+  if (axis >= dims.size()) {
+    throw pjrt::Exception("DeviceOps::gather: axis " + std::to_string(axis) + " is out of range for shape " + shapeString(dims) + ".");
+  }
+
+  // Every index selects a slice of size 1 along `axis` and the whole extent of the other dimensions. The collapsed axis is
+  // replaced by the index dimension, at the same position in the result.
+  std::vector<int64_t> sliceSizes = dims.toVector();
+  sliceSizes[axis] = 1;
+  Shape resultDims = dims;
+  resultDims[axis] = indices.dimensions()[0];
+  std::string offsetDims;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    if (i != axis) {
+      offsetDims += (offsetDims.empty() ? "" : ", ") + std::to_string(i);
+    }
+  }
+
+  const PJRT_Buffer_Type type = input.elementType();
+  const std::string inputType = detail::mlirTensorType(dims, type);
+  const std::string indicesType = detail::mlirTensorType(indices.dimensions(), indexType);
+  const std::string resultType = detail::mlirTensorType(resultDims, type);
+  return run("gather " + std::to_string(axis) + " " + inputType + " " + indicesType, [&]() {
+    return moduleText("device_gather", {inputType, indicesType}, resultType,
+                      "    %result = \"stablehlo.gather\"(%arg0, %arg1) {dimension_numbers = #stablehlo.gather<offset_dims = [" + offsetDims +
+                      "], collapsed_slice_dims = [" + std::to_string(axis) + "], start_index_map = [" + std::to_string(axis) +
+                      "], index_vector_dim = 1>, slice_sizes = " + detail::mlirI64Array(sliceSizes) + ", indices_are_sorted = false} : (" +
+                      inputType + ", " + indicesType + ") -> " + resultType + "\n");
+  }, {&input, &indices});
+}
+
+size_t DeviceOps::numCachedPrograms() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return programs_.size();
+}
+
+DeviceOps::Stats DeviceOps::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+Buffer DeviceOps::run(const std::string &signature, const std::function<std::string()> &generateProgram, const std::vector<const Buffer*> &operands,
+                      std::vector<Buffer> &&uploadedOperands) {
+  std::shared_future<std::shared_ptr<LoadedExecutable>> program;
+  std::promise<std::shared_ptr<LoadedExecutable>> compiled;
+  uint64_t id = 0;
+  bool compile = false;
+  {
+    // Only the lookup holds the lock. The first caller of a signature compiles it below; later ones wait on its future.
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto cached = programs_.find(signature);
+    if (cached != programs_.end()) {
+      ++stats_.programCacheHits;
+      recency_.splice(recency_.begin(), recency_, cached->second.recency);
+    } else {
+      recency_.push_front(signature);
+      id = nextId_++;
+      cached = programs_.emplace(signature, CachedProgram{compiled.get_future().share(), id, recency_.begin()}).first;
+      compile = true;
+      ++stats_.programsCompiled;
+      while (programs_.size() > options_.maxPrograms && programs_.size() > 1) {
+        // Launches holding the evicted program keep it alive until they are done with it.
+        programs_.erase(recency_.back());
+        recency_.pop_back();
+        ++stats_.programsEvicted;
+      }
+    }
+    program = cached->second.program;
+  }
+
+  if (compile) {
+    try {
+      compiled.set_value(std::make_shared<LoadedExecutable>(client_.compileFromStableHloString(generateProgram())));
+    } catch (const std::exception &) {
+      compiled.set_exception(std::current_exception());
+      // Let the next call try again rather than fail on the cached error, unless the entry was evicted and replaced since.
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto cached = programs_.find(signature);
+      if (cached != programs_.end() && cached->second.id == id) {
+        recency_.erase(cached->second.recency);
+        programs_.erase(cached);
+      }
+    }
+  }
+  const std::shared_ptr<LoadedExecutable> executable = program.get();
+
+  std::vector<PJRT_Buffer*> arguments;
+  arguments.reserve(operands.size() + uploadedOperands.size());
+  for (const Buffer *operand : operands) {
+    arguments.push_back(operand->c_buffer());
+  }
+  for (const Buffer &operand : uploadedOperands) {
+    arguments.push_back(operand.c_buffer());
+  }
+  auto [outputs, event] = executable->launch(device_, arguments, /*allowDonation=*/false);
+  // Not waited for: PJRT orders later uses of the output after the execution, and reports its errors through the output.
+  // The callback only keeps the program and the uploaded operands alive until the execution has completed.
+  std::unique_ptr<detail::CallbackUserData<void>> callbackUserData = std::make_unique<detail::CallbackUserData<void>>(client_.context_);
+  callbackUserData->keepAlive(executable);
+  if (!uploadedOperands.empty()) {
+    callbackUserData->keepAlive(std::make_shared<const std::vector<Buffer>>(std::move(uploadedOperands)));
+  }
+  client_.context_.getFutureForEvent(event, std::move(callbackUserData));
+  return std::move(outputs[0]);
+}
+
+} // namespace pjrt
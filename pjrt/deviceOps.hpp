@@ -0,0 +1,120 @@
+#ifndef PJRT_DEVICE_OPS_HPP_
+#define PJRT_DEVICE_OPS_HPP_
+
+#include "buffer.hpp"
+#include "loadedExecutable.hpp"
+#include "shape.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace pjrt {
+
+class Client;
+class DeviceView;
+
+// Tensor manipulations which run on a device, so that slicing, concatenating, converting, reshaping, padding or gathering
+// a buffer does not round-trip through host memory.
+//
+// Each op generates a small StableHLO program specialized to its operands' shapes and element types, compiles it on first
+// use and caches it by that signature; later calls with the same signature only launch it. Values which do not affect the
+// result's shape, the start of a slice and the padding value, are uploaded as scalar operands instead of being compiled in,
+// so e.g. a sliding window reuses one program. Beyond Options::maxPrograms, the least recently used program is dropped.
+// A signature is compiled by one thread at a time, without holding up ops whose programs are cached.
+//
+// Like Buffer::copyToDevice(), every op is asynchronous: the returned buffer may be used right away, e.g. as an argument to
+// the next op, and errors of the execution surface when it is read. Operands are never donated and stay valid.
+//
+// `client` and `device` must outlive the ops, and operands must live on `device`. Thread-safe.
+class DeviceOps {
+public:
+  struct Options {
+    // Compiled programs kept at most.
+    size_t maxPrograms{64};
+  };
+
+  struct Stats {
+    uint64_t programsCompiled{0};
+    uint64_t programCacheHits{0};
+    uint64_t programsEvicted{0};
+  };
+
+  DeviceOps(const Client &client, const DeviceView &device, Options options);
+  DeviceOps(const Client &client, const DeviceView &device) : DeviceOps(client, device, Options()) {}
+  DeviceOps(const DeviceOps &) = delete;
+  DeviceOps& operator=(const DeviceOps &) = delete;
+
+  // Elements [start, limit) of every dimension, taking every strides[i]-th one. Empty `strides` means 1 everywhere.
+  Buffer slice(const Buffer &input, const std::vector<int64_t> &start, const std::vector<int64_t> &limit, const std::vector<int64_t> &strides = {});
+
+  // Joins `inputs` along `axis`. They must have the same element type and agree in every other dimension.
+  Buffer concatenate(const std::vector<const Buffer*> &inputs, size_t axis);
+
+  // Converts every element to `type`, with the rounding and saturation of stablehlo.convert.
+  Buffer convert(const Buffer &input, PJRT_Buffer_Type type);
+
+  // The same elements in row-major order with the dimensions `shape`, which must hold as many elements.
+  Buffer reshape(const Buffer &input, const Shape &shape);
+
+  // Adds low[i] and high[i] elements before and after dimension i, and interior[i] between its elements, filled with
+  // `paddingValue`, which must be representable in an integer operand's type. Negative edge padding removes elements. Empty
+  // `interior` means no interior padding.
+  Buffer pad(const Buffer &input, const std::vector<int64_t> &low, const std::vector<int64_t> &high, double paddingValue = 0.0, const std::vector<int64_t> &interior = {});
+
+  // Takes the slices of `input` along `axis` at the positions in the rank-1 integer buffer `indices`, so that the result's
+  // dimension `axis` has one entry per index. Out-of-range indices are clamped, as stablehlo.gather does.
+  Buffer gather(const Buffer &input, const Buffer &indices, size_t axis = 0);
+
+  // Number of op signatures whose programs are cached, including those being compiled.
+  size_t numCachedPrograms() const;
+
+  Stats stats() const;
+private:
+  struct CachedProgram {
+    // Ready once the program has been compiled. Shared so that an eviction does not pull it from under a launch.
+    std::shared_future<std::shared_ptr<LoadedExecutable>> program;
+    // Identifies this compilation, so that a failed one only removes its own entry.
+    uint64_t id;
+    std::list<std::string>::iterator recency;
+  };
+
+  // Launches the program cached under `signature`, compiling `generateProgram()` first if there is none. `operands` are
+  // followed by `uploadedOperands`, which are kept alive until the launch completes.
+  Buffer run(const std::string &signature, const std::function<std::string()> &generateProgram, const std::vector<const Buffer*> &operands,
+             std::vector<Buffer> &&uploadedOperands = {});
+
+  const Client &client_;
+  const DeviceView &device_;
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, CachedProgram> programs_;
+  // Signatures from most to least recently used.
+  std::list<std::string> recency_;
+  uint64_t nextId_{0};
+  Stats stats_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_DEVICE_OPS_HPP_
@@ -55,4 +55,72 @@ std::string DeviceView::description() const {
   return std::string(to_string_args.to_string, to_string_args.to_string_size);
 }
 
+int DeviceView::localHardwareId() const {
+  PJRT_Device_LocalHardwareId_Args args;
+  args.struct_size = PJRT_Device_LocalHardwareId_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.device = device_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Device_LocalHardwareId(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Device_LocalHardwareId", __FILE__, __LINE__);
+  }
+  return args.local_hardware_id;
+}
+
+MemoryStats DeviceView::memoryStats() const {
+  PJRT_Device_MemoryStats_Args args;
+  args.struct_size = PJRT_Device_MemoryStats_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.device = device_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Device_MemoryStats(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Device_MemoryStats", __FILE__, __LINE__);
+  }
+
+  auto optional = [](bool isSet, int64_t value) { return (isSet ? std::optional<int64_t>(value) : std::nullopt); };
+  MemoryStats stats;
+  stats.bytesInUse = args.bytes_in_use;
+  stats.peakBytesInUse = optional(args.peak_bytes_in_use_is_set, args.peak_bytes_in_use);
+  stats.numAllocs = optional(args.num_allocs_is_set, args.num_allocs);
+  stats.largestAllocSize = optional(args.largest_alloc_size_is_set, args.largest_alloc_size);
+  stats.bytesLimit = optional(args.bytes_limit_is_set, args.bytes_limit);
+  stats.bytesReserved = optional(args.bytes_reserved_is_set, args.bytes_reserved);
+  stats.peakBytesReserved = optional(args.peak_bytes_reserved_is_set, args.peak_bytes_reserved);
+  stats.bytesReservableLimit = optional(args.bytes_reservable_limit_is_set, args.bytes_reservable_limit);
+  stats.largestFreeBlockBytes = optional(args.largest_free_block_bytes_is_set, args.largest_free_block_bytes);
+  stats.poolBytes = optional(args.pool_bytes_is_set, args.pool_bytes);
+  stats.peakPoolBytes = optional(args.peak_pool_bytes_is_set, args.peak_pool_bytes);
+  return stats;
+}
+
+std::vector<MemoryView> DeviceView::addressableMemories() const {
+  PJRT_Device_AddressableMemories_Args args;
+  args.struct_size = PJRT_Device_AddressableMemories_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.device = device_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Device_AddressableMemories(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Device_AddressableMemories", __FILE__, __LINE__);
+  }
+
+  std::vector<MemoryView> memories;
+  memories.reserve(args.num_memories);
+  for (size_t i = 0; i < args.num_memories; ++i) {
+    memories.emplace_back(context_, args.memories[i]);
+  }
+  return memories;
+}
+
+MemoryView DeviceView::defaultMemory() const {
+  PJRT_Device_DefaultMemory_Args args;
+  args.struct_size = PJRT_Device_DefaultMemory_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.device = device_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Device_DefaultMemory(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Device_DefaultMemory", __FILE__, __LINE__);
+  }
+  return MemoryView(context_, args.memory);
+}
+
 } // namespace pjrt
\ No newline at end of file
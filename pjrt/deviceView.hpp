@@ -1,7 +1,11 @@
 #ifndef PJRT_DEVICE_VIEW_HPP_
 #define PJRT_DEVICE_VIEW_HPP_
 
+#include "memoryStats.hpp"
+#include "memoryView.hpp"
+
 #include <string>
+#include <vector>
 
 struct PJRT_Device;
 
@@ -17,6 +21,16 @@ public:
   // No destructor because PJRT_Client owns the devices and no cleanup is required in this class.
 
   std::string description() const;
+
+  // Opaque hardware ID, e.g. the CUDA device number.
+  int localHardwareId() const;
+
+  // The memories this device can address, and the one it uses by default.
+  std::vector<MemoryView> addressableMemories() const;
+  MemoryView defaultMemory() const;
+
+  // Current allocator statistics of the device. Intended for diagnostics; plugins may report this as unimplemented, which throws.
+  MemoryStats memoryStats() const;
 public:
 // private:
   const Context &context_;
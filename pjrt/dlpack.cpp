@@ -0,0 +1,72 @@
+#include "dlpack.hpp"
+#include "exception.hpp"
+
+#include <string>
+
+namespace pjrt::detail {
+
+DLDataType toDLDataType(PJRT_Buffer_Type type) {
+  switch (type) {
+    case PJRT_Buffer_Type_PRED: return {kDLBool, 8, 1};
+    case PJRT_Buffer_Type_S8:   return {kDLInt, 8, 1};
+    case PJRT_Buffer_Type_S16:  return {kDLInt, 16, 1};
+    case PJRT_Buffer_Type_S32:  return {kDLInt, 32, 1};
+    case PJRT_Buffer_Type_S64:  return {kDLInt, 64, 1};
+    case PJRT_Buffer_Type_U8:   return {kDLUInt, 8, 1};
+    case PJRT_Buffer_Type_U16:  return {kDLUInt, 16, 1};
+    case PJRT_Buffer_Type_U32:  return {kDLUInt, 32, 1};
+    case PJRT_Buffer_Type_U64:  return {kDLUInt, 64, 1};
+    case PJRT_Buffer_Type_F16:  return {kDLFloat, 16, 1};
+    case PJRT_Buffer_Type_F32:  return {kDLFloat, 32, 1};
+    case PJRT_Buffer_Type_F64:  return {kDLFloat, 64, 1};
+    case PJRT_Buffer_Type_BF16: return {kDLBfloat, 16, 1};
+    case PJRT_Buffer_Type_C64:  return {kDLComplex, 64, 1};
+    case PJRT_Buffer_Type_C128: return {kDLComplex, 128, 1};
+    default:
+      throw pjrt::Exception("PJRT buffer type " + std::to_string(static_cast<int>(type)) + " has no DLPack equivalent.");
+  }
+}
+
+PJRT_Buffer_Type fromDLDataType(DLDataType dataType) {
+  if (dataType.lanes != 1) {
+    throw pjrt::Exception("Vectorized DLPack data types (lanes != 1) are not supported.");
+  }
+  switch (dataType.code) {
+    case kDLBool:
+      if (dataType.bits == 8) return PJRT_Buffer_Type_PRED;
+      break;
+    case kDLInt:
+      switch (dataType.bits) {
+        case 8:  return PJRT_Buffer_Type_S8;
+        case 16: return PJRT_Buffer_Type_S16;
+        case 32: return PJRT_Buffer_Type_S32;
+        case 64: return PJRT_Buffer_Type_S64;
+      }
+      break;
+    case kDLUInt:
+      switch (dataType.bits) {
+        case 8:  return PJRT_Buffer_Type_U8;
+        case 16: return PJRT_Buffer_Type_U16;
+        case 32: return PJRT_Buffer_Type_U32;
+        case 64: return PJRT_Buffer_Type_U64;
+      }
+      break;
+    case kDLFloat:
+      switch (dataType.bits) {
+        case 16: return PJRT_Buffer_Type_F16;
+        case 32: return PJRT_Buffer_Type_F32;
+        case 64: return PJRT_Buffer_Type_F64;
+      }
+      break;
+    case kDLBfloat:
+      if (dataType.bits == 16) return PJRT_Buffer_Type_BF16;
+      break;
+    case kDLComplex:
+      if (dataType.bits == 64) return PJRT_Buffer_Type_C64;
+      if (dataType.bits == 128) return PJRT_Buffer_Type_C128;
+      break;
+  }
+  throw pjrt::Exception("DLPack data type (code " + std::to_string(dataType.code) + ", " + std::to_string(dataType.bits) + " bits) has no PJRT equivalent.");
+}
+
+} // namespace pjrt::detail
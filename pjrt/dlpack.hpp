@@ -0,0 +1,78 @@
+#ifndef PJRT_DLPACK_HPP_
+#define PJRT_DLPACK_HPP_
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstdint>
+
+// Use the real DLPack header when it is available. Otherwise, declare the subset of the (stable) DLPack ABI which we need.
+// If the real header is used elsewhere in your program, make sure it is found here too, or include it before this header.
+#if __has_include(<dlpack/dlpack.h>)
+#include <dlpack/dlpack.h>
+#elif !defined(DLPACK_VERSION)
+
+typedef enum {
+  kDLCPU = 1,
+  kDLCUDA = 2,
+  kDLCUDAHost = 3,
+  kDLROCM = 10,
+} DLDeviceType;
+
+typedef struct {
+  DLDeviceType device_type;
+  int32_t device_id;
+} DLDevice;
+
+typedef enum {
+  kDLInt = 0U,
+  kDLUInt = 1U,
+  kDLFloat = 2U,
+  kDLOpaqueHandle = 3U,
+  kDLBfloat = 4U,
+  kDLComplex = 5U,
+  kDLBool = 6U,
+} DLDataTypeCode;
+
+typedef struct {
+  uint8_t code;
+  uint8_t bits;
+  uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+  void *data;
+  DLDevice device;
+  int32_t ndim;
+  DLDataType dtype;
+  int64_t *shape;
+  int64_t *strides;
+  uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+  DLTensor dl_tensor;
+  void *manager_ctx;
+  void (*deleter)(struct DLManagedTensor *self);
+} DLManagedTensor;
+
+#endif
+
+namespace pjrt::detail {
+
+// Conversions between PJRT element types and DLPack data types. Both throw pjrt::Exception for types without an equivalent.
+DLDataType toDLDataType(PJRT_Buffer_Type type);
+PJRT_Buffer_Type fromDLDataType(DLDataType dataType);
+
+} // namespace pjrt::detail
+
+#endif // PJRT_DLPACK_HPP_
@@ -72,7 +72,7 @@ size_t Executable::getNumOutputs() const {
   return args.num_outputs;
 }
 
-std::vector<std::vector<int64_t>> Executable::getOutputDimensions() const {
+std::vector<Shape> Executable::getOutputDimensions() const {
   PJRT_Executable_OutputDimensions_Args args;
   args.struct_size = PJRT_Executable_OutputDimensions_Args_STRUCT_SIZE;
   args.executable = executable_;
@@ -81,16 +81,51 @@ std::vector<std::vector<int64_t>> Executable::getOutputDimensions() const {
     throw context_.convertPjrtErrorToException(error, "PJRT_Executable_OutputDimensions", __FILE__, __LINE__);
   }
 
-  std::vector<std::vector<int64_t>> all_dimensions;
+  std::vector<Shape> all_dimensions;
   all_dimensions.reserve(args.num_outputs);
   const int64_t* current_dim_ptr = args.dims;
   for (size_t i = 0; i < args.num_outputs; ++i) {
     size_t num_dims_for_output = args.dim_sizes[i];
-    std::vector<int64_t> dimensions(current_dim_ptr, current_dim_ptr + num_dims_for_output);
-    all_dimensions.push_back(std::move(dimensions));
+    all_dimensions.emplace_back(current_dim_ptr, num_dims_for_output);
     current_dim_ptr += num_dims_for_output;
   }
   return all_dimensions;
 }
 
-} // namespace pjrt
\ No newline at end of file
+CompiledMemoryStats Executable::getCompiledMemoryStats() const {
+  PJRT_Executable_GetCompiledMemoryStats_Args args;
+  args.struct_size = PJRT_Executable_GetCompiledMemoryStats_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.executable = executable_;
+  PJRT_Error *error = context_.pjrtApi_->PJRT_Executable_GetCompiledMemoryStats(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Executable_GetCompiledMemoryStats", __FILE__, __LINE__);
+  }
+  CompiledMemoryStats stats;
+  stats.generatedCodeSizeInBytes = args.generated_code_size_in_bytes;
+  stats.argumentSizeInBytes = args.argument_size_in_bytes;
+  stats.outputSizeInBytes = args.output_size_in_bytes;
+  stats.aliasSizeInBytes = args.alias_size_in_bytes;
+  stats.tempSizeInBytes = args.temp_size_in_bytes;
+  stats.peakMemoryInBytes = args.peak_memory_in_bytes;
+  return stats;
+}
+
+std::string Executable::serialize() const {
+  PJRT_Executable_Serialize_Args args;
+  args.struct_size = PJRT_Executable_Serialize_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.executable = executable_;
+  PJRT_Error *error = context_.pjrtApi_->PJRT_Executable_Serialize(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Executable_Serialize", __FILE__, __LINE__);
+  }
+  // The bytes are only valid until the deleter runs.
+  std::string serialized(args.serialized_bytes, args.serialized_bytes_size);
+  if (args.serialized_executable_deleter != nullptr) {
+    args.serialized_executable_deleter(args.serialized_executable);
+  }
+  return serialized;
+}
+
+} // namespace pjrt
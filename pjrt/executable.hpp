@@ -1,7 +1,11 @@
 #ifndef PJRT_EXECUTABLE_HPP_
 #define PJRT_EXECUTABLE_HPP_
 
+#include "memoryStats.hpp"
+#include "shape.hpp"
+
 #include <cstddef>
+#include <string>
 #include <vector>
 
 struct PJRT_Executable;
@@ -20,7 +24,12 @@ public:
   void destroy();
 
   size_t getNumOutputs() const;
-  std::vector<std::vector<int64_t>> getOutputDimensions() const;
+  std::vector<Shape> getOutputDimensions() const;
+  // Throws if the plugin does not report compiled memory statistics.
+  CompiledMemoryStats getCompiledMemoryStats() const;
+  // The plugin's serialization of the compiled program, which Client::deserializeAndLoad() turns back into a
+  // LoadedExecutable. Only valid for the same platform and plugin version.
+  std::string serialize() const;
 private:
   const Context &context_;
   PJRT_Executable *executable_;
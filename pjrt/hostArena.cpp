@@ -0,0 +1,129 @@
+#include "buffer.hpp"
+#include "context.hpp"
+#include "detail/callbackUserData.hpp"
+#include "hostArena.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <atomic>
+#include <cassert>
+#include <mutex>
+
+namespace pjrt {
+
+namespace {
+
+// Shared by the callbacks of every copy in one readbackAll() call. The last callback to finish fulfills the promise and frees this.
+struct ReadbackAllState {
+  ReadbackAllState(const Context &context, HostArena &&arena, size_t pendingCount) : callbackUserData(context, std::move(arena)), pending(pendingCount) {}
+
+  detail::CallbackUserData<HostArena> callbackUserData;
+  std::atomic<size_t> pending;
+  std::mutex errorMutex;
+  std::exception_ptr firstError;
+
+  void recordError(std::exception_ptr &&error) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!firstError) {
+      firstError = std::move(error);
+    }
+  }
+
+  // Marks `count` of the pending operations as finished. The caller must not touch `state` after this returns.
+  static void finish(ReadbackAllState *state, size_t count) {
+    if (state->pending.fetch_sub(count) != count) {
+      return;
+    }
+    if (state->firstError) {
+      state->callbackUserData.setException(std::move(state->firstError));
+    } else {
+      state->callbackUserData.fulfill();
+    }
+    delete state;
+  }
+};
+
+void readbackAllEventReadyCallback(PJRT_Error *error, void *userArgument) {
+  assert(((void)"User argument is null", userArgument != nullptr));
+  ReadbackAllState *state = static_cast<ReadbackAllState*>(userArgument);
+  if (error != nullptr) {
+    state->recordError(std::make_exception_ptr(state->callbackUserData.getContext().convertPjrtErrorToException(error, "PJRT error when calling user-provided callback", __FILE__, __LINE__)));
+  }
+  ReadbackAllState::finish(state, 1);
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+std::future<HostArena> readbackAll(const std::vector<Buffer*> &buffers) {
+  if (buffers.empty()) {
+    std::promise<HostArena> promise;
+    promise.set_value(HostArena());
+    return promise.get_future();
+  }
+  const Context &context = buffers.front()->context_;
+
+  // Lay out one slot per buffer.
+  HostArena arena;
+  arena.offsets_.reserve(buffers.size());
+  arena.sizes_.reserve(buffers.size());
+  size_t totalSize = 0;
+  for (const Buffer *buffer : buffers) {
+    assert(((void)"Cannot read back Buffers from different contexts together", &buffer->context_ == &context));
+    const size_t size = buffer->queryHostBufferSize();
+    totalSize = alignUp(totalSize, HostArena::kSlotAlignment);
+    arena.offsets_.push_back(totalSize);
+    arena.sizes_.push_back(size);
+    totalSize += size;
+  }
+  arena.storage_.reset(new std::byte[totalSize]);
+
+  // One pending operation per copy, plus one for this function so that the state outlives the loop below.
+  ReadbackAllState *state = new ReadbackAllState(context, std::move(arena), buffers.size() + 1);
+  std::future<HostArena> future = state->callbackUserData.getFuture();
+  const HostArena &stateArena = state->callbackUserData.getData();
+
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    PJRT_Event *event = nullptr;
+    try {
+      event = buffers[i]->issueToHostBuffer(stateArena.storage_.get() + stateArena.offsets_[i], stateArena.sizes_[i]);
+    } catch (...) {
+      state->recordError(std::current_exception());
+      // Copies which were already issued still complete and release the state. Those which were never issued never will.
+      ReadbackAllState::finish(state, buffers.size() - i + 1);
+      throw;
+    }
+
+    PJRT_Event_OnReady_Args eventOnReadyArgs;
+    eventOnReadyArgs.struct_size = PJRT_Event_OnReady_Args_STRUCT_SIZE;
+    eventOnReadyArgs.extension_start = nullptr;
+    eventOnReadyArgs.event = event;
+    eventOnReadyArgs.callback = &readbackAllEventReadyCallback;
+    eventOnReadyArgs.user_arg = state;
+    PJRT_Error *eventReadyError = context.pjrtApi_->PJRT_Event_OnReady(&eventOnReadyArgs);
+    if (eventReadyError != nullptr) {
+      const Exception exception = context.convertPjrtErrorToException(eventReadyError, "PJRT_Event_OnReady", __FILE__, __LINE__);
+      state->recordError(std::make_exception_ptr(exception));
+      ReadbackAllState::finish(state, buffers.size() - i + 1);
+      throw exception;
+    }
+  }
+
+  ReadbackAllState::finish(state, 1);
+  return future;
+}
+
+} // namespace pjrt
@@ -0,0 +1,49 @@
+#ifndef PJRT_HOST_ARENA_HPP_
+#define PJRT_HOST_ARENA_HPP_
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace pjrt {
+
+class Buffer;
+
+// A single contiguous block of host memory holding the readback of several buffers, one slot per buffer.
+// Every slot starts on a kSlotAlignment-byte boundary relative to the start of the block.
+class HostArena {
+public:
+  static constexpr size_t kSlotAlignment = 64;
+
+  HostArena() = default;
+  HostArena(HostArena &&other) = default;
+  HostArena& operator=(HostArena &&other) = default;
+
+  // Number of slots, i.e. the number of buffers read back.
+  size_t size() const { return offsets_.size(); }
+
+  size_t sizeInBytes(size_t slot) const { return sizes_.at(slot); }
+
+  template<typename T>
+  const T* data(size_t slot) const { return reinterpret_cast<const T*>(storage_.get() + offsets_.at(slot)); }
+
+  template<typename T>
+  size_t count(size_t slot) const { return sizeInBytes(slot) / sizeof(T); }
+private:
+  friend std::future<HostArena> readbackAll(const std::vector<Buffer*> &buffers);
+
+  // Left uninitialized; every byte of every slot is written by the readback.
+  std::unique_ptr<std::byte[]> storage_;
+  std::vector<size_t> offsets_;
+  std::vector<size_t> sizes_;
+};
+
+// Asynchronously copies all `buffers` to the host at once, into one HostArena.
+// Compared to calling toHost() on each buffer, this does one host allocation and fulfills a single future once every copy has completed.
+// If any copy fails, the future holds the first error.
+std::future<HostArena> readbackAll(const std::vector<Buffer*> &buffers);
+
+} // namespace pjrt
+
+#endif // PJRT_HOST_ARENA_HPP_
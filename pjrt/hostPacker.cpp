@@ -0,0 +1,204 @@
+#include "hostPacker.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace pjrt {
+
+namespace {
+
+size_t lastLevelCacheSize() {
+  long size = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+  size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+  if (size <= 0) {
+    size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  }
+#endif
+  // Unknown; assume a typical desktop L3.
+  return (size > 0 ? static_cast<size_t>(size) : size_t{8} << 20);
+}
+
+void pinCurrentThread(size_t cpu) {
+#if defined(__linux__)
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpu % CPU_SETSIZE, &cpuSet);
+  // Pinning is an optimization; ignore failures, e.g. from a restricted CPU set.
+  pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+#else
+  (void)cpu;
+#endif
+}
+
+} // namespace
+
+HostPacker::HostPacker() : HostPacker(Options()) {}
+
+HostPacker::HostPacker(const Options &options) : minBytesPerThread_(options.minBytesPerThread), nonTemporalThreshold_(options.nonTemporalThreshold) {
+  if (nonTemporalThreshold_ == 0) {
+    nonTemporalThreshold_ = lastLevelCacheSize();
+  }
+  size_t numThreads = options.numThreads;
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  workers_.reserve(numThreads - 1);
+  for (size_t i = 0; i + 1 < numThreads; ++i) {
+    workers_.emplace_back([this, i, pin = options.pinThreads]() {
+      if (pin) {
+        pinCurrentThread(i + 1);
+      }
+      workerLoop(i);
+    });
+  }
+  if (options.pinThreads) {
+    pinCurrentThread(0);
+  }
+}
+
+HostPacker::~HostPacker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  workAvailable_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+void HostPacker::parallelFor(size_t count, size_t minCountPerThread, const std::function<void(size_t, size_t)> &function) {
+  if (count == 0) {
+    return;
+  }
+  const size_t numChunks = std::min(numThreads(), (count + minCountPerThread - 1) / std::max<size_t>(1, minCountPerThread));
+  if (numChunks <= 1) {
+    function(0, count);
+    return;
+  }
+
+  std::lock_guard<std::mutex> operationLock(operationMutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    function_ = &function;
+    count_ = count;
+    numChunks_ = numChunks;
+    pendingChunks_ = numChunks - 1;
+    error_ = nullptr;
+    ++generation_;
+  }
+  workAvailable_.notify_all();
+
+  // The calling thread always takes chunk 0.
+  runChunk(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  workDone_.wait(lock, [this]() { return pendingChunks_ == 0; });
+  function_ = nullptr;
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void HostPacker::copy(void *destination, const void *source, size_t sizeInBytes) {
+  // Chunks are split at the destination's cache line boundaries, counted from the line containing its first byte, so
+  // threads never share a destination line even if `destination` is not line-aligned.
+  constexpr size_t kLineSize = 64;
+  const bool nonTemporal = useNonTemporal(sizeInBytes);
+  const size_t misalignment = reinterpret_cast<uintptr_t>(destination) % kLineSize;
+  const size_t numLines = (misalignment + sizeInBytes + kLineSize - 1) / kLineSize;
+  parallelFor(numLines, minCountPerThread(kLineSize), [&](size_t beginLine, size_t endLine) {
+    const size_t begin = (beginLine == 0 ? 0 : beginLine * kLineSize - misalignment);
+    const size_t end = std::min(endLine * kLineSize - misalignment, sizeInBytes);
+    store(static_cast<std::byte*>(destination) + begin, static_cast<const std::byte*>(source) + begin, end - begin, nonTemporal);
+  });
+}
+
+void HostPacker::gather(void *destination, const void *const *rows, size_t numRows, size_t rowSizeInBytes) {
+  const bool nonTemporal = useNonTemporal(numRows * rowSizeInBytes);
+  parallelFor(numRows, minCountPerThread(rowSizeInBytes), [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; ++row) {
+      store(static_cast<std::byte*>(destination) + row * rowSizeInBytes, rows[row], rowSizeInBytes, nonTemporal);
+    }
+  });
+}
+
+void HostPacker::store(void *destination, const void *source, size_t sizeInBytes, bool nonTemporal) {
+#if defined(__SSE2__)
+  if (nonTemporal) {
+    std::byte *out = static_cast<std::byte*>(destination);
+    const std::byte *in = static_cast<const std::byte*>(source);
+    // Streaming stores need 16-byte aligned destinations; copy the unaligned head and tail normally.
+    const size_t head = std::min(sizeInBytes, (16 - reinterpret_cast<uintptr_t>(out) % 16) % 16);
+    std::memcpy(out, in, head);
+    size_t offset = head;
+    for (; offset + 16 <= sizeInBytes; offset += 16) {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(out + offset), _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset)));
+    }
+    std::memcpy(out + offset, in + offset, sizeInBytes - offset);
+    return;
+  }
+#else
+  (void)nonTemporal;
+#endif
+  std::memcpy(destination, source, sizeInBytes);
+}
+
+void HostPacker::workerLoop(size_t workerIndex) {
+  uint64_t seenGeneration = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      workAvailable_.wait(lock, [&]() { return stopping_ || generation_ != seenGeneration; });
+      if (stopping_) {
+        return;
+      }
+      seenGeneration = generation_;
+      if (workerIndex + 1 >= numChunks_) {
+        // This operation has fewer chunks than threads.
+        continue;
+      }
+    }
+    runChunk(workerIndex + 1);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --pendingChunks_;
+      if (pendingChunks_ != 0) {
+        continue;
+      }
+    }
+    workDone_.notify_one();
+  }
+}
+
+void HostPacker::runChunk(size_t chunk) {
+  // function_, count_ and numChunks_ don't change while any chunk of the operation is pending.
+  const size_t begin = count_ * chunk / numChunks_;
+  const size_t end = count_ * (chunk + 1) / numChunks_;
+  try {
+    (*function_)(begin, end);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_) {
+      error_ = std::current_exception();
+    }
+  }
+#if defined(__SSE2__)
+  // Make this thread's streaming stores visible before the operation is reported complete.
+  _mm_sfence();
+#endif
+}
+
+} // namespace pjrt
@@ -0,0 +1,136 @@
+#ifndef PJRT_HOST_PACKER_HPP_
+#define PJRT_HOST_PACKER_HPP_
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pjrt {
+
+// Parallel host-side copy, convert and gather, for building large staging buffers before a transfer.
+//
+// Work is split into contiguous chunks, one per thread, and chunk i of an operation always runs on the same thread. When a
+// freshly allocated destination is first written through a HostPacker, each thread therefore touches its own pages first.
+// Under a first-touch placement policy (Linux's default), those pages land on the NUMA node the thread ran on at the time;
+// enable `pinThreads` so that stays the node it runs on. Nothing here enforces placement: pages the caller already touched,
+// or other memory policies, decide otherwise. Destinations larger than the last-level cache are written with non-temporal
+// stores, so they don't evict the sources.
+//
+// Client transfers read the caller's memory directly and do no staging copy of their own, so the packer is not part of
+// them; use it to build the host block before a transfer, e.g. through CoalescedUploader.
+//
+// Operations below `minBytesPerThread` run on the calling thread only. Operations from several threads are serialized.
+class HostPacker {
+public:
+  struct Options {
+    // Total number of threads working on an operation, including the calling thread. 0 means one per hardware thread.
+    size_t numThreads{0};
+    // Smallest amount of output worth handing to another thread.
+    size_t minBytesPerThread{size_t{256} << 10};
+    // Destinations of at least this many bytes use non-temporal stores. 0 means the size of the last-level cache.
+    size_t nonTemporalThreshold{0};
+    // Pin worker i to CPU i+1 (Linux only).
+    bool pinThreads{false};
+  };
+
+  HostPacker();
+  explicit HostPacker(const Options &options);
+  HostPacker(const HostPacker &) = delete;
+  HostPacker& operator=(const HostPacker &) = delete;
+  ~HostPacker();
+
+  size_t numThreads() const { return workers_.size() + 1; }
+  size_t nonTemporalThreshold() const { return nonTemporalThreshold_; }
+
+  // Calls `function(begin, end)` on disjoint, contiguous subranges covering [0, count), in parallel.
+  // `minCountPerThread` bounds how finely the range is split. Rethrows the first exception thrown by `function`.
+  void parallelFor(size_t count, size_t minCountPerThread, const std::function<void(size_t, size_t)> &function);
+
+  void copy(void *destination, const void *source, size_t sizeInBytes);
+
+  // destination[i] = static_cast<Destination>(source[i]) * scale
+  template <typename Destination, typename Source>
+  void convert(Destination *destination, const Source *source, size_t count, Destination scale = Destination(1));
+
+  // Concatenates `numRows` rows of `rowSizeInBytes` bytes each into `destination`.
+  void gather(void *destination, const void *const *rows, size_t numRows, size_t rowSizeInBytes);
+
+  // Concatenates `numRows` rows of `rowLength` elements each into `destination`, converting and scaling every element.
+  template <typename Destination, typename Source>
+  void gatherConvert(Destination *destination, const Source *const *rows, size_t numRows, size_t rowLength, Destination scale = Destination(1));
+private:
+  // Elements are converted into a block on the stack, which is then stored to the destination.
+  static constexpr size_t kBlockSizeInBytes = 4096;
+
+  // Copies `sizeInBytes` bytes, with non-temporal stores if requested and supported.
+  static void store(void *destination, const void *source, size_t sizeInBytes, bool nonTemporal);
+
+  template <typename Destination, typename Source>
+  static void convertRange(Destination *destination, const Source *source, size_t count, Destination scale, bool nonTemporal);
+
+  bool useNonTemporal(size_t sizeInBytes) const { return sizeInBytes >= nonTemporalThreshold_; }
+  size_t minCountPerThread(size_t bytesPerItem) const { return std::max<size_t>(1, minBytesPerThread_ / std::max<size_t>(1, bytesPerItem)); }
+
+  void workerLoop(size_t workerIndex);
+  void runChunk(size_t chunk);
+
+  size_t minBytesPerThread_;
+  size_t nonTemporalThreshold_;
+  std::vector<std::thread> workers_;
+
+  // Serializes operations.
+  std::mutex operationMutex_;
+
+  // The current operation, guarded by mutex_.
+  std::mutex mutex_;
+  std::condition_variable workAvailable_;
+  std::condition_variable workDone_;
+  uint64_t generation_{0};
+  bool stopping_{false};
+  const std::function<void(size_t, size_t)> *function_{nullptr};
+  size_t count_{0};
+  size_t numChunks_{0};
+  size_t pendingChunks_{0};
+  std::exception_ptr error_;
+};
+
+template <typename Destination, typename Source>
+void HostPacker::convertRange(Destination *destination, const Source *source, size_t count, Destination scale, bool nonTemporal) {
+  constexpr size_t kBlockLength = kBlockSizeInBytes / sizeof(Destination);
+  alignas(64) Destination block[kBlockLength];
+  for (size_t offset = 0; offset < count; offset += kBlockLength) {
+    const size_t length = std::min(kBlockLength, count - offset);
+    for (size_t i = 0; i < length; ++i) {
+      block[i] = static_cast<Destination>(source[offset + i]) * scale;
+    }
+    store(destination + offset, block, length * sizeof(Destination), nonTemporal);
+  }
+}
+
+template <typename Destination, typename Source>
+void HostPacker::convert(Destination *destination, const Source *source, size_t count, Destination scale) {
+  const bool nonTemporal = useNonTemporal(count * sizeof(Destination));
+  parallelFor(count, minCountPerThread(sizeof(Destination)), [&](size_t begin, size_t end) {
+    convertRange(destination + begin, source + begin, end - begin, scale, nonTemporal);
+  });
+}
+
+template <typename Destination, typename Source>
+void HostPacker::gatherConvert(Destination *destination, const Source *const *rows, size_t numRows, size_t rowLength, Destination scale) {
+  const bool nonTemporal = useNonTemporal(numRows * rowLength * sizeof(Destination));
+  parallelFor(numRows, minCountPerThread(rowLength * sizeof(Destination)), [&](size_t begin, size_t end) {
+    for (size_t row = begin; row < end; ++row) {
+      convertRange(destination + row * rowLength, rows[row], rowLength, scale, nonTemporal);
+    }
+  });
+}
+
+} // namespace pjrt
+
+#endif // PJRT_HOST_PACKER_HPP_
@@ -0,0 +1,63 @@
+#ifndef PJRT_HOST_VIEW_HPP_
+#define PJRT_HOST_VIEW_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+struct PJRT_Buffer;
+
+namespace pjrt {
+
+class Context;
+
+namespace detail {
+
+// Drops an external reference taken with PJRT_Buffer_IncreaseExternalReferenceCount. Errors are logged, not thrown.
+void decreaseExternalReferenceCount(const Context &context, PJRT_Buffer *buffer) noexcept;
+
+} // namespace detail
+
+// Read-only access to the elements of a Buffer from the host, see Buffer::hostView().
+// Either points directly at the buffer's memory, which is then pinned by an external reference until the view is destroyed,
+// or owns a copy. In the first case the Buffer must outlive the view and must not be donated or written to meanwhile.
+template <typename T>
+class HostView {
+public:
+  // Moving a vector keeps its storage, so data_ stays valid for copies too.
+  HostView(HostView &&other) : context_(other.context_), pinnedBuffer_(std::exchange(other.pinnedBuffer_, nullptr)), data_(other.data_), size_(other.size_), copy_(std::move(other.copy_)) {}
+  HostView(const HostView &) = delete;
+  HostView& operator=(const HostView &) = delete;
+  HostView& operator=(HostView &&) = delete;
+
+  ~HostView() {
+    if (pinnedBuffer_ != nullptr) {
+      detail::decreaseExternalReferenceCount(*context_, pinnedBuffer_);
+    }
+  }
+
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+  const T& operator[](size_t index) const { return data_[index]; }
+
+  // Whether the view points directly at the buffer's memory rather than at a copy.
+  bool isZeroCopy() const { return pinnedBuffer_ != nullptr; }
+// private:
+  // Zero-copy view of `size` elements at `data`, which is kept alive by an external reference on `pinnedBuffer`.
+  HostView(const Context &context, PJRT_Buffer *pinnedBuffer, const T *data, size_t size) : context_(&context), pinnedBuffer_(pinnedBuffer), data_(data), size_(size) {}
+  // View of a copy.
+  explicit HostView(std::vector<T> &&copy) : data_(nullptr), size_(copy.size()), copy_(std::move(copy)) { data_ = copy_.data(); }
+
+  const Context *context_{nullptr};
+  PJRT_Buffer *pinnedBuffer_{nullptr};
+  const T *data_;
+  size_t size_;
+  std::vector<T> copy_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_HOST_VIEW_HPP_
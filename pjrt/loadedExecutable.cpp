@@ -4,6 +4,7 @@
 #include "event.hpp"
 #include "executable.hpp"
 #include "loadedExecutable.hpp"
+#include "shardedArray.hpp"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -18,20 +19,43 @@
 #endif
 
   #include <cassert>
+#include <numeric>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 namespace pjrt {
 
-LoadedExecutable::LoadedExecutable(const Context &context, PJRT_LoadedExecutable *loadedExecutable) : context_(context), loadedExecutable_(loadedExecutable) {}
+LoadedExecutable::LoadedExecutable(const Context &context, PJRT_LoadedExecutable *loadedExecutable) : context_(context), loadedExecutable_(loadedExecutable) {
+  if (loadedExecutable_ == nullptr) {
+    return;
+  }
+  try {
+    const Executable executable = getExecutable();
+    outputShapes_ = executable.getOutputDimensions();
+    try {
+      compiledMemoryStats_ = executable.getCompiledMemoryStats();
+    } catch (const pjrt::Exception &) {
+      // Not every plugin reports compiled memory statistics.
+    }
+  } catch (const pjrt::Exception &) {
+    // The destructor does not run when a constructor throws, so release the executable here. The original error is the one reported.
+    try {
+      destroy();
+    } catch (const pjrt::Exception &) {}
+    throw;
+  }
+}
 
-LoadedExecutable::LoadedExecutable(LoadedExecutable &&other) : context_(other.context_), loadedExecutable_(other.loadedExecutable_) {
+LoadedExecutable::LoadedExecutable(LoadedExecutable &&other) : context_(other.context_), loadedExecutable_(other.loadedExecutable_), outputShapes_(std::move(other.outputShapes_)), compiledMemoryStats_(other.compiledMemoryStats_) {
   other.loadedExecutable_ = nullptr;
 }
 
 LoadedExecutable& LoadedExecutable::operator=(LoadedExecutable &&other) {
   assert(((void)"Cannot assign a LoadedExecutable from one context to another", &other.context_ == &context_));
   loadedExecutable_ = other.loadedExecutable_;
+  outputShapes_ = std::move(other.outputShapes_);
+  compiledMemoryStats_ = other.compiledMemoryStats_;
   other.loadedExecutable_ = nullptr;
   return *this;
 }
@@ -66,19 +90,57 @@ void LoadedExecutable::destroy() {
 }
 
 std::future<std::vector<Buffer>> LoadedExecutable::execute(
-    const DeviceView& device, std::vector<Buffer*>& argument_handles) {
+    const DeviceView& device, std::vector<Buffer*>& argument_handles, bool allowDonation) {
+  return executeBuffers(device, argument_handles, allowDonation, nullptr);
+}
+
+std::future<std::vector<Buffer>> LoadedExecutable::executeBuffers(
+    const DeviceView& device, std::vector<Buffer*>& argument_handles, bool allowDonation, std::shared_ptr<const void> keepAlive) {
+  std::vector<PJRT_Buffer*> arguments(argument_handles.size());
+  for (size_t i=0; i<argument_handles.size(); ++i) {
+    arguments[i] = argument_handles[i]->c_buffer();
+  }
+  auto [outputs, event] = launch(device, arguments, allowDonation);
+  if (allowDonation) {
+    for (const Buffer *argument : argument_handles) {
+      argument->forgetIfDonated();
+    }
+  }
+
+  // Create CallbackUserData with the fully formed Buffer
+  std::unique_ptr<detail::CallbackUserData<std::vector<Buffer>>> callbackUserData =
+      std::make_unique<detail::CallbackUserData<std::vector<Buffer>>>(context_, std::move(outputs));
+  if (keepAlive != nullptr) {
+    callbackUserData->keepAlive(std::move(keepAlive));
+  }
+
+  return context_.getFutureForEvent(event, std::move(callbackUserData));
+}
+
+std::future<std::vector<Buffer>> LoadedExecutable::execute(
+    const DeviceView& device, const std::vector<SharedBuffer>& sharedArguments) {
+  std::vector<PJRT_Buffer*> arguments(sharedArguments.size());
+  for (size_t i=0; i<sharedArguments.size(); ++i) {
+    arguments[i] = sharedArguments[i]->c_buffer();
+  }
+  auto [outputs, event] = launch(device, arguments, /*allowDonation=*/false);
+
+  std::unique_ptr<detail::CallbackUserData<std::vector<Buffer>>> callbackUserData =
+      std::make_unique<detail::CallbackUserData<std::vector<Buffer>>>(context_, std::move(outputs));
+  // The references are dropped when PJRT is done with the callback data, after the launch has completed.
+  for (const SharedBuffer &argument : sharedArguments) {
+    callbackUserData->keepAlive(argument.buffer_);
+  }
+
+  return context_.getFutureForEvent(event, std::move(callbackUserData));
+}
+
+std::pair<std::vector<Buffer>, PJRT_Event*> LoadedExecutable::launch(
+    const DeviceView& device, const std::vector<PJRT_Buffer*>& arguments, bool allowDonation) {
   // Prepare and Execute the Compiled Program
   PJRT_ExecuteOptions exec_options;
-  exec_options.struct_size = PJRT_ExecuteOptions_STRUCT_SIZE;
-  exec_options.extension_start = nullptr;
-  exec_options.launch_id = 0; // Default launch ID
-  exec_options.num_send_ops = 0;
-  exec_options.send_callbacks = nullptr;
-  exec_options.num_recv_ops = 0;
-  exec_options.recv_callbacks = nullptr;
-  exec_options.non_donatable_input_indices = nullptr;
-  exec_options.num_non_donatable_input_indices = 0;
-  exec_options.context = nullptr;
+  std::vector<int64_t> nonDonatableIndices;
+  fillExecuteOptions(exec_options, nonDonatableIndices, arguments.size(), allowDonation);
 
   PJRT_LoadedExecutable_Execute_Args exec_args;
   exec_args.struct_size = PJRT_LoadedExecutable_Execute_Args_STRUCT_SIZE;
@@ -87,20 +149,15 @@ std::future<std::vector<Buffer>> LoadedExecutable::execute(
   exec_args.options = &exec_options;
 
   // Argument lists: Our program takes multiple arguments. We are executing on 1 device.
-  std::vector<PJRT_Buffer*> actual_input_buffers_for_device0(argument_handles.size());
-  for (size_t i=0; i<argument_handles.size(); ++i) {
-    actual_input_buffers_for_device0[i] = argument_handles[i]->c_buffer();
-  }
   PJRT_Buffer* const* argument_lists_for_all_devices[] = {
-      actual_input_buffers_for_device0.data()
+      arguments.data()
   };
   exec_args.argument_lists = argument_lists_for_all_devices;
   exec_args.num_devices = 1; // We are launching on a single device instance here
-  exec_args.num_args = argument_handles.size();
+  exec_args.num_args = arguments.size();
 
     // Output setup
-  const Executable executable = getExecutable();
-  std::vector<PJRT_Buffer*> raw_output_c_buffers(executable.getNumOutputs());
+  std::vector<PJRT_Buffer*> raw_output_c_buffers(outputShapes_.size());
   PJRT_Buffer** output_list_for_device0[1];
   output_list_for_device0[0] = raw_output_c_buffers.data();
   exec_args.output_lists = output_list_for_device0;
@@ -116,18 +173,142 @@ std::future<std::vector<Buffer>> LoadedExecutable::execute(
     throw context_.convertPjrtErrorToException(exec_error, "PJRT_LoadedExecutable_Execute", __FILE__, __LINE__);
   }
 
-  const std::vector<std::vector<int64_t>> outputDimensions = executable.getOutputDimensions();
   std::vector<Buffer> final_output_buffers;
-  final_output_buffers.reserve(executable.getNumOutputs());
-  for (size_t i = 0; i < executable.getNumOutputs(); ++i) {
-    final_output_buffers.emplace_back(context_, raw_output_c_buffers[i], std::move(outputDimensions[i]));
+  final_output_buffers.reserve(outputShapes_.size());
+  for (size_t i = 0; i < outputShapes_.size(); ++i) {
+    final_output_buffers.emplace_back(context_, raw_output_c_buffers[i], outputShapes_[i]);
   }
+  return {std::move(final_output_buffers), device_complete_event_handles[0]};
+}
 
-  // Create CallbackUserData with the fully formed Buffer
-  std::unique_ptr<detail::CallbackUserData<std::vector<Buffer>>> callbackUserData =
-      std::make_unique<detail::CallbackUserData<std::vector<Buffer>>>(context_, std::move(final_output_buffers));
+std::future<std::vector<ShardedArray>> LoadedExecutable::execute(
+    const std::vector<ShardedArray*>& arguments, const std::vector<ShardingSpec>& outputSharding, bool allowDonation) {
+  if (outputSharding.size() != outputShapes_.size()) {
+    throw pjrt::Exception("Expected a sharding for each of the " + std::to_string(outputShapes_.size()) + " outputs, got " + std::to_string(outputSharding.size()) + ".");
+  }
+  const std::vector<DeviceView> devices = addressableDevices();
+  const size_t numDevices = devices.size();
 
-  return context_.getFutureForEvent(device_complete_event_handles[0], std::move(callbackUserData));
+  // One argument list per device, holding that device's shard of every argument.
+  std::vector<std::vector<PJRT_Buffer*>> argumentLists(numDevices, std::vector<PJRT_Buffer*>(arguments.size()));
+  for (size_t a = 0; a < arguments.size(); ++a) {
+    const ShardedArray &argument = *arguments[a];
+    if (argument.numShards() != numDevices) {
+      throw pjrt::Exception("Argument " + std::to_string(a) + " has " + std::to_string(argument.numShards()) + " shards, but the executable runs on " + std::to_string(numDevices) + " devices.");
+    }
+    for (size_t d = 0; d < numDevices; ++d) {
+      if (argument.shard(d).device().device_ != devices[d].device_) {
+        throw pjrt::Exception("Shard " + std::to_string(d) + " of argument " + std::to_string(a) + " does not live on the executable's device " + std::to_string(d) + ".");
+      }
+      argumentLists[d][a] = argument.shard(d).c_buffer();
+    }
+  }
+  std::vector<PJRT_Buffer* const*> argumentListPointers(numDevices);
+  for (size_t d = 0; d < numDevices; ++d) {
+    argumentListPointers[d] = argumentLists[d].data();
+  }
+
+  PJRT_ExecuteOptions exec_options;
+  std::vector<int64_t> nonDonatableIndices;
+  fillExecuteOptions(exec_options, nonDonatableIndices, arguments.size(), allowDonation);
+
+  std::vector<std::vector<PJRT_Buffer*>> outputLists(numDevices, std::vector<PJRT_Buffer*>(outputShapes_.size()));
+  std::vector<PJRT_Buffer**> outputListPointers(numDevices);
+  for (size_t d = 0; d < numDevices; ++d) {
+    outputListPointers[d] = outputLists[d].data();
+  }
+  std::vector<PJRT_Event*> completeEvents(numDevices);
+
+  PJRT_LoadedExecutable_Execute_Args exec_args;
+  exec_args.struct_size = PJRT_LoadedExecutable_Execute_Args_STRUCT_SIZE;
+  exec_args.extension_start = nullptr;
+  exec_args.executable = loadedExecutable_;
+  exec_args.options = &exec_options;
+  exec_args.argument_lists = argumentListPointers.data();
+  exec_args.num_devices = numDevices;
+  exec_args.num_args = arguments.size();
+  exec_args.output_lists = outputListPointers.data();
+  exec_args.device_complete_events = completeEvents.data();
+  exec_args.execute_device = nullptr; // Run every replica on its assigned device.
+
+  PJRT_Error* exec_error = context_.pjrtApi_->PJRT_LoadedExecutable_Execute(&exec_args);
+  if (exec_error != nullptr) {
+    throw context_.convertPjrtErrorToException(exec_error, "PJRT_LoadedExecutable_Execute", __FILE__, __LINE__);
+  }
+  if (allowDonation) {
+    for (const ShardedArray *argument : arguments) {
+      for (const Buffer &shard : argument->shards()) {
+        shard.forgetIfDonated();
+      }
+    }
+  }
+
+  // Group the outputs by output index rather than by device.
+  std::vector<std::vector<Buffer>> shardsPerOutput(outputShapes_.size());
+  for (size_t o = 0; o < outputShapes_.size(); ++o) {
+    shardsPerOutput[o].reserve(numDevices);
+    for (size_t d = 0; d < numDevices; ++d) {
+      shardsPerOutput[o].emplace_back(context_, outputLists[d][o], outputShapes_[o]);
+    }
+  }
+  std::vector<std::future<void>> completions;
+  completions.reserve(numDevices);
+  for (PJRT_Event *event : completeEvents) {
+    completions.push_back(context_.getFutureForEvent(event, std::make_unique<detail::CallbackUserData<void>>(context_)));
+  }
+
+  // Deferred, like the futures of ShardedArray: the launches are already running, get() waits for all of them.
+  return std::async(std::launch::deferred, [outputSharding, shardsPerOutput = std::move(shardsPerOutput), completions = std::move(completions)]() mutable {
+    for (std::future<void> &completion : completions) {
+      completion.get();
+    }
+    std::vector<ShardedArray> outputs;
+    outputs.reserve(shardsPerOutput.size());
+    for (size_t o = 0; o < shardsPerOutput.size(); ++o) {
+      outputs.emplace_back(outputSharding[o], std::move(shardsPerOutput[o]));
+    }
+    return outputs;
+  });
+}
+
+std::vector<DeviceView> LoadedExecutable::addressableDevices() const {
+  PJRT_LoadedExecutable_AddressableDevices_Args args;
+  args.struct_size = PJRT_LoadedExecutable_AddressableDevices_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.executable = loadedExecutable_;
+  PJRT_Error *error = context_.pjrtApi_->PJRT_LoadedExecutable_AddressableDevices(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_LoadedExecutable_AddressableDevices", __FILE__, __LINE__);
+  }
+  std::vector<DeviceView> devices;
+  devices.reserve(args.num_addressable_devices);
+  for (size_t i = 0; i < args.num_addressable_devices; ++i) {
+    devices.emplace_back(context_, args.addressable_devices[i]);
+  }
+  return devices;
+}
+
+std::string LoadedExecutable::serialize() const {
+  return getExecutable().serialize();
+}
+
+void LoadedExecutable::fillExecuteOptions(PJRT_ExecuteOptions &options, std::vector<int64_t> &nonDonatableIndices, size_t numArguments, bool allowDonation) {
+  options.struct_size = PJRT_ExecuteOptions_STRUCT_SIZE;
+  options.extension_start = nullptr;
+  options.launch_id = 0; // Default launch ID
+  options.num_send_ops = 0;
+  options.send_callbacks = nullptr;
+  options.num_recv_ops = 0;
+  options.recv_callbacks = nullptr;
+  // E.g. shared arguments may still be read by other users, so none of them may be donated.
+  nonDonatableIndices.clear();
+  if (!allowDonation) {
+    nonDonatableIndices.resize(numArguments);
+    std::iota(nonDonatableIndices.begin(), nonDonatableIndices.end(), 0);
+  }
+  options.non_donatable_input_indices = nonDonatableIndices.data();
+  options.num_non_donatable_input_indices = nonDonatableIndices.size();
+  options.context = nullptr;
 }
 
 Executable LoadedExecutable::getExecutable() const {
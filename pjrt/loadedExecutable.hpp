@@ -3,15 +3,27 @@
 
 #include "buffer.hpp"
 #include "executable.hpp"
+#include "sharedBuffer.hpp"
 
+#include <cstdint>
 #include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
+struct PJRT_Event;
 struct PJRT_LoadedExecutable;
 
 namespace pjrt {
 
+class AdmissionController;
 class Context;
+class DeviceOps;
 class DeviceView;
+class ShardedArray;
+class ShardingSpec;
 
 class LoadedExecutable {
 public:
@@ -22,15 +34,61 @@ public:
 
   void destroy();
 
+  // Shapes of the program's outputs. Queried once on construction, so that execute() does not ask PJRT on every call.
+  const std::vector<Shape>& outputShapes() const { return outputShapes_; }
+
+  // With `allowDonation` false, the program's input/output aliasing is ignored and every argument stays valid after the execution.
+  std::future<std::vector<Buffer>> execute(const DeviceView& device,
+                                           std::vector<Buffer*>& argument_handles,
+                                           bool allowDonation = true);
+
+  // Executes with shared arguments. Each argument is kept alive until the execution has completed, even if every other
+  // SharedBuffer referring to it is destroyed first, and none of them is donated. May be called from several threads at once.
   std::future<std::vector<Buffer>> execute(const DeviceView& device,
-                                           std::vector<Buffer*>& argument_handles);
+                                           const std::vector<SharedBuffer>& arguments);
+
+  // Launches a program compiled for several replicas on all of its devices at once. Device i receives shard i of every
+  // argument, which must live on device i of addressableDevices(). Output j is assembled with `outputSharding[j]`; the
+  // per-device output shapes do not tell a replicated output from a split one, so the caller has to.
+  std::future<std::vector<ShardedArray>> execute(const std::vector<ShardedArray*>& arguments,
+                                                 const std::vector<ShardingSpec>& outputSharding,
+                                                 bool allowDonation = true);
+
+  // The devices the executable runs on, one per replica, in replica order.
+  std::vector<DeviceView> addressableDevices() const;
+
+  // Memory the compiler determined an execution needs. Queried once on construction; empty if the plugin does not report it.
+  const std::optional<CompiledMemoryStats>& compiledMemoryStats() const { return compiledMemoryStats_; }
+
+  // See Executable::serialize().
+  std::string serialize() const;
 public:
 // private:
   const Context &context_;
   PJRT_LoadedExecutable *loadedExecutable_;
+  std::vector<Shape> outputShapes_;
+  std::optional<CompiledMemoryStats> compiledMemoryStats_;
   
 private:
+  friend class AdmissionController;
+  friend class DeviceOps;
+
   Executable getExecutable() const;
+
+  // Implements execute() with Buffer arguments. `keepAlive`, if set, is released once the execution has completed.
+  std::future<std::vector<Buffer>> executeBuffers(const DeviceView& device,
+                                                  std::vector<Buffer*>& argument_handles,
+                                                  bool allowDonation,
+                                                  std::shared_ptr<const void> keepAlive);
+
+  // Launches the executable on `device`. Returns the output buffers and the event which signals completion of the launch.
+  std::pair<std::vector<Buffer>, PJRT_Event*> launch(const DeviceView& device,
+                                                     const std::vector<PJRT_Buffer*>& arguments,
+                                                     bool allowDonation);
+
+  // Fills `options` for a launch with `numArguments` arguments per device. `nonDonatableIndices` backs the options and must
+  // outlive the launch.
+  static void fillExecuteOptions(PJRT_ExecuteOptions &options, std::vector<int64_t> &nonDonatableIndices, size_t numArguments, bool allowDonation);
 };
 
 } // namespace pjrt
@@ -0,0 +1,78 @@
+#include "memoryLayout.hpp"
+
+namespace pjrt {
+
+MemoryLayout::MemoryLayout(PJRT_Buffer_MemoryLayout_Type type) : type_(type) {}
+
+MemoryLayout MemoryLayout::tiled(std::vector<int64_t> minorToMajor, const std::vector<std::vector<int64_t>> &tiles) {
+  MemoryLayout layout(PJRT_Buffer_MemoryLayout_Type_Tiled);
+  layout.minorToMajor_ = std::move(minorToMajor);
+  for (const std::vector<int64_t> &tile : tiles) {
+    layout.tileDims_.insert(layout.tileDims_.end(), tile.begin(), tile.end());
+    layout.tileDimSizes_.push_back(tile.size());
+  }
+  return layout;
+}
+
+MemoryLayout MemoryLayout::majorToMinor(const std::vector<int64_t> &majorToMinor) {
+  return tiled(std::vector<int64_t>(majorToMinor.rbegin(), majorToMinor.rend()));
+}
+
+MemoryLayout MemoryLayout::strided(std::vector<int64_t> byteStrides) {
+  MemoryLayout layout(PJRT_Buffer_MemoryLayout_Type_Strides);
+  layout.byteStrides_ = std::move(byteStrides);
+  return layout;
+}
+
+MemoryLayout MemoryLayout::fromCLayout(const PJRT_Buffer_MemoryLayout &layout) {
+  if (layout.type == PJRT_Buffer_MemoryLayout_Type_Strides) {
+    return strided(std::vector<int64_t>(layout.strides.byte_strides, layout.strides.byte_strides + layout.strides.num_byte_strides));
+  }
+  MemoryLayout result(PJRT_Buffer_MemoryLayout_Type_Tiled);
+  result.minorToMajor_.assign(layout.tiled.minor_to_major, layout.tiled.minor_to_major + layout.tiled.minor_to_major_size);
+  result.tileDimSizes_.assign(layout.tiled.tile_dim_sizes, layout.tiled.tile_dim_sizes + layout.tiled.num_tiles);
+  size_t numTileDims = 0;
+  for (size_t tileDimSize : result.tileDimSizes_) {
+    numTileDims += tileDimSize;
+  }
+  result.tileDims_.assign(layout.tiled.tile_dims, layout.tiled.tile_dims + numTileDims);
+  return result;
+}
+
+bool MemoryLayout::isDenseMajorToMinor() const {
+  if (type_ != PJRT_Buffer_MemoryLayout_Type_Tiled || !tileDimSizes_.empty()) {
+    return false;
+  }
+  // Major-to-minor means minorToMajor is {rank-1, ..., 0}.
+  const size_t rank = minorToMajor_.size();
+  for (size_t i = 0; i < rank; ++i) {
+    if (minorToMajor_[i] != static_cast<int64_t>(rank - 1 - i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+PJRT_Buffer_MemoryLayout MemoryLayout::c_layout() const {
+  PJRT_Buffer_MemoryLayout layout;
+  layout.struct_size = PJRT_Buffer_MemoryLayout_STRUCT_SIZE;
+  layout.extension_start = nullptr;
+  layout.type = type_;
+  if (type_ == PJRT_Buffer_MemoryLayout_Type_Tiled) {
+    layout.tiled.struct_size = PJRT_Buffer_MemoryLayout_Tiled_STRUCT_SIZE;
+    layout.tiled.extension_start = nullptr;
+    layout.tiled.minor_to_major = minorToMajor_.data();
+    layout.tiled.minor_to_major_size = minorToMajor_.size();
+    layout.tiled.tile_dims = tileDims_.data();
+    layout.tiled.tile_dim_sizes = tileDimSizes_.data();
+    layout.tiled.num_tiles = tileDimSizes_.size();
+  } else {
+    layout.strides.struct_size = PJRT_Buffer_MemoryLayout_Strides_STRUCT_SIZE;
+    layout.strides.extension_start = nullptr;
+    layout.strides.byte_strides = byteStrides_.data();
+    layout.strides.num_byte_strides = byteStrides_.size();
+  }
+  return layout;
+}
+
+} // namespace pjrt
@@ -0,0 +1,63 @@
+#ifndef PJRT_MEMORY_LAYOUT_HPP_
+#define PJRT_MEMORY_LAYOUT_HPP_
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pjrt {
+
+// Owns the data behind a PJRT_Buffer_MemoryLayout. A layout is either
+//  1. Tiled: a minor-to-major ordering of the logical dimensions, plus optional tiles, or
+//  2. Strided: a byte stride for each logical dimension.
+class MemoryLayout {
+public:
+  // A layout given by the order of logical dimensions from most minor (fastest varying) to most major.
+  static MemoryLayout tiled(std::vector<int64_t> minorToMajor, const std::vector<std::vector<int64_t>> &tiles = {});
+
+  // Convenience for the common "transpose" case. `majorToMinor` lists the logical dimensions in the order they should be laid out in memory.
+  // For example, reading an NHWC buffer with majorToMinor({0, 3, 1, 2}) produces NCHW data.
+  static MemoryLayout majorToMinor(const std::vector<int64_t> &majorToMinor);
+
+  // A layout given by the number of bytes to step for each logical dimension.
+  static MemoryLayout strided(std::vector<int64_t> byteStrides);
+
+  // Copies a layout reported by PJRT, e.g. by PJRT_Buffer_GetMemoryLayout.
+  static MemoryLayout fromCLayout(const PJRT_Buffer_MemoryLayout &layout);
+
+  PJRT_Buffer_MemoryLayout_Type type() const { return type_; }
+  const std::vector<int64_t>& minorToMajor() const { return minorToMajor_; }
+  const std::vector<int64_t>& byteStrides() const { return byteStrides_; }
+  size_t numTiles() const { return tileDimSizes_.size(); }
+
+  // Whether this is the dense, untiled, major-to-minor (row-major) layout which host data normally has.
+  bool isDenseMajorToMinor() const;
+
+  // Returns a PJRT struct which points into this object. It is only valid while this object is alive and unmodified.
+  PJRT_Buffer_MemoryLayout c_layout() const;
+private:
+  explicit MemoryLayout(PJRT_Buffer_MemoryLayout_Type type);
+
+  PJRT_Buffer_MemoryLayout_Type type_;
+  std::vector<int64_t> minorToMajor_;
+  // All tile dimensions concatenated. `tileDimSizes_` holds the number of dimensions of each tile.
+  std::vector<int64_t> tileDims_;
+  std::vector<size_t> tileDimSizes_;
+  std::vector<int64_t> byteStrides_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_MEMORY_LAYOUT_HPP_
@@ -0,0 +1,41 @@
+#ifndef PJRT_MEMORY_STATS_HPP_
+#define PJRT_MEMORY_STATS_HPP_
+
+#include <cstdint>
+#include <optional>
+
+namespace pjrt {
+
+// A snapshot of a device's allocator statistics. Only bytesInUse is reported by every plugin; the rest is optional.
+struct MemoryStats {
+  int64_t bytesInUse{0};
+  std::optional<int64_t> peakBytesInUse;
+  std::optional<int64_t> numAllocs;
+  std::optional<int64_t> largestAllocSize;
+  // Upper limit of user-allocatable device memory.
+  std::optional<int64_t> bytesLimit;
+  std::optional<int64_t> bytesReserved;
+  std::optional<int64_t> peakBytesReserved;
+  std::optional<int64_t> bytesReservableLimit;
+  // A largest free block much smaller than the free memory indicates fragmentation.
+  std::optional<int64_t> largestFreeBlockBytes;
+  // Memory held by the allocator, which may exceed bytesInUse for pooling allocators.
+  std::optional<int64_t> poolBytes;
+  std::optional<int64_t> peakPoolBytes;
+};
+
+// What the compiler determined an executable needs, in bytes of the device's default memory.
+struct CompiledMemoryStats {
+  int64_t generatedCodeSizeInBytes{0};
+  int64_t argumentSizeInBytes{0};
+  int64_t outputSizeInBytes{0};
+  // Part of the outputs which reuses donated argument memory.
+  int64_t aliasSizeInBytes{0};
+  // Scratch memory, only allocated while the executable runs.
+  int64_t tempSizeInBytes{0};
+  int64_t peakMemoryInBytes{0};
+};
+
+} // namespace pjrt
+
+#endif // PJRT_MEMORY_STATS_HPP_
@@ -0,0 +1,73 @@
+#include "memoryView.hpp"
+#include "context.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cassert>
+
+namespace pjrt {
+
+MemoryView::MemoryView(const Context &context, PJRT_Memory *memory) : context_(context), memory_(memory) {
+
+}
+
+MemoryView::MemoryView(MemoryView &&other) : context_(other.context_), memory_(other.memory_) {
+  other.memory_ = nullptr;
+}
+
+MemoryView& MemoryView::operator=(MemoryView &&other) {
+  assert(((void)"Cannot assign a MemoryView from one context to another", &other.context_ == &context_));
+  if (this == &other) {
+    return *this;
+  }
+  memory_ = other.memory_;
+  other.memory_ = nullptr;
+  return *this;
+}
+
+int MemoryView::id() const {
+  PJRT_Memory_Id_Args args;
+  args.struct_size = PJRT_Memory_Id_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.memory = memory_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Memory_Id(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Memory_Id", __FILE__, __LINE__);
+  }
+  return args.id;
+}
+
+std::string MemoryView::kind() const {
+  PJRT_Memory_Kind_Args args;
+  args.struct_size = PJRT_Memory_Kind_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.memory = memory_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Memory_Kind(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Memory_Kind", __FILE__, __LINE__);
+  }
+  return std::string(args.kind, args.kind_size);
+}
+
+std::string MemoryView::description() const {
+  PJRT_Memory_ToString_Args args;
+  args.struct_size = PJRT_Memory_ToString_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.memory = memory_;
+  PJRT_Error* error = context_.pjrtApi_->PJRT_Memory_ToString(&args);
+  if (error != nullptr) {
+    throw context_.convertPjrtErrorToException(error, "PJRT_Memory_ToString", __FILE__, __LINE__);
+  }
+  return std::string(args.to_string, args.to_string_size);
+}
+
+} // namespace pjrt
@@ -0,0 +1,32 @@
+#ifndef PJRT_MEMORY_VIEW_HPP_
+#define PJRT_MEMORY_VIEW_HPP_
+
+#include <string>
+
+struct PJRT_Memory;
+
+namespace pjrt {
+
+class Context;
+
+// A memory space, such as a device's own memory ("device") or host memory usable by a device ("pinned_host").
+class MemoryView {
+public:
+  MemoryView(const Context &context, PJRT_Memory *memory);
+  MemoryView(MemoryView &&other);
+  MemoryView& operator=(MemoryView &&other);
+  // No destructor because PJRT_Client owns the memories and no cleanup is required in this class.
+
+  int id() const;
+  // Platform-dependent kind, e.g. "device", "pinned_host" or "unpinned_host".
+  std::string kind() const;
+  std::string description() const;
+public:
+// private:
+  const Context &context_;
+  PJRT_Memory *memory_{nullptr};
+};
+
+} // namespace pjrt
+
+#endif // PJRT_MEMORY_VIEW_HPP_
@@ -0,0 +1,98 @@
+#include "memoryWatermarkSampler.hpp"
+#include "deviceView.hpp"
+#include "exception.hpp"
+
+#include <algorithm>
+
+namespace pjrt {
+
+MemoryWatermarkSampler::MemoryWatermarkSampler(const DeviceView &device, std::chrono::milliseconds interval) : device_(device), interval_(interval) {
+  phases_.push_back(PhaseWatermark{"default", 0, 0, std::nullopt, std::nullopt});
+  thread_ = std::thread([this]() { run(); });
+}
+
+MemoryWatermarkSampler::~MemoryWatermarkSampler() {
+  stop();
+}
+
+void MemoryWatermarkSampler::setPhase(const std::string &phase) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(phases_.begin(), phases_.end(), [&](const PhaseWatermark &watermark) { return watermark.phase == phase; });
+    if (it == phases_.end()) {
+      it = phases_.insert(phases_.end(), PhaseWatermark{phase, 0, 0, std::nullopt, std::nullopt});
+    }
+    currentPhase_ = it - phases_.begin();
+  }
+  sample();
+}
+
+void MemoryWatermarkSampler::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wakeUp_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+bool MemoryWatermarkSampler::supported() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return supported_;
+}
+
+std::vector<MemoryWatermarkSampler::PhaseWatermark> MemoryWatermarkSampler::watermarks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<PhaseWatermark> result;
+  // Leave out the implicit phase before the first setPhase() if nothing was sampled in it.
+  for (const PhaseWatermark &watermark : phases_) {
+    if (watermark.numSamples > 0 || &watermark != &phases_.front()) {
+      result.push_back(watermark);
+    }
+  }
+  return result;
+}
+
+void MemoryWatermarkSampler::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_ && supported_) {
+    lock.unlock();
+    sample();
+    lock.lock();
+    wakeUp_.wait_for(lock, interval_, [this]() { return stopping_; });
+  }
+}
+
+void MemoryWatermarkSampler::sample() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!supported_) {
+      return;
+    }
+  }
+
+  MemoryStats stats;
+  try {
+    stats = device_.memoryStats();
+  } catch (const pjrt::Exception &) {
+    // E.g. unimplemented by the plugin. Statistics are diagnostics, so don't propagate.
+    std::lock_guard<std::mutex> lock(mutex_);
+    supported_ = false;
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  PhaseWatermark &watermark = phases_[currentPhase_];
+  ++watermark.numSamples;
+  watermark.peakBytesInUse = std::max(watermark.peakBytesInUse, stats.bytesInUse);
+  if (stats.largestFreeBlockBytes) {
+    watermark.minLargestFreeBlockBytes = std::min(watermark.minLargestFreeBlockBytes.value_or(*stats.largestFreeBlockBytes), *stats.largestFreeBlockBytes);
+  }
+  if (stats.bytesLimit) {
+    watermark.bytesLimit = stats.bytesLimit;
+  }
+}
+
+} // namespace pjrt
@@ -0,0 +1,69 @@
+#ifndef PJRT_MEMORY_WATERMARK_SAMPLER_HPP_
+#define PJRT_MEMORY_WATERMARK_SAMPLER_HPP_
+
+#include "memoryStats.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pjrt {
+
+class DeviceView;
+
+// Samples a device's memory statistics on a background thread and records high-water marks per phase, e.g. "compile",
+// "init" and "train_step". Phases may be entered repeatedly; their watermarks accumulate.
+//
+// `device` must outlive the sampler. If the plugin does not report memory statistics, sampling stops and supported()
+// returns false.
+class MemoryWatermarkSampler {
+public:
+  struct PhaseWatermark {
+    std::string phase;
+    size_t numSamples{0};
+    int64_t peakBytesInUse{0};
+    // The smallest largest-free-block seen, if reported. Low values relative to free memory indicate fragmentation.
+    std::optional<int64_t> minLargestFreeBlockBytes;
+    std::optional<int64_t> bytesLimit;
+  };
+
+  MemoryWatermarkSampler(const DeviceView &device, std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+  MemoryWatermarkSampler(const MemoryWatermarkSampler &) = delete;
+  MemoryWatermarkSampler& operator=(const MemoryWatermarkSampler &) = delete;
+  ~MemoryWatermarkSampler();
+
+  // Attributes subsequent samples to `phase`. Samples once at the boundary, so that short phases are not missed.
+  void setPhase(const std::string &phase);
+
+  // Stops the background thread. Watermarks remain available.
+  void stop();
+
+  bool supported() const;
+
+  // Watermarks of every phase, in order of first use.
+  std::vector<PhaseWatermark> watermarks() const;
+private:
+  void run();
+  void sample();
+
+  const DeviceView &device_;
+  const std::chrono::milliseconds interval_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable wakeUp_;
+  bool stopping_{false};
+  bool supported_{true};
+  size_t currentPhase_{0};
+  std::vector<PhaseWatermark> phases_;
+  std::thread thread_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_MEMORY_WATERMARK_SAMPLER_HPP_
@@ -0,0 +1,262 @@
+#include "normalizingPrologue.hpp"
+#include "detail/stableHloText.hpp"
+#include "exception.hpp"
+
+#include <cctype>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace pjrt {
+
+namespace {
+
+struct Parameter {
+  // Type, e.g. "tensor<128x784xf32>".
+  std::string type;
+  // Attribute dictionary including its braces, or empty.
+  std::string attributes;
+};
+
+std::string trim(const std::string &text) {
+  size_t begin = 0;
+  size_t end = text.size();
+  while (begin < end && std::isspace(static_cast<unsigned char>(text[begin]))) {
+    ++begin;
+  }
+  while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+    --end;
+  }
+  return text.substr(begin, end - begin);
+}
+
+size_t skipSpace(const std::string &text, size_t position) {
+  while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+    ++position;
+  }
+  return position;
+}
+
+// Calls `visit(position, depthBefore, depthAfter)` for each character outside string literals, with the bracket nesting depth around it.
+// Stops when `visit` returns true, returning that position, or at the end of `text`, returning npos.
+template <typename Visitor>
+size_t scan(const std::string &text, size_t begin, size_t end, Visitor visit) {
+  int depth = 0;
+  bool inString = false;
+  for (size_t i = begin; i < end; ++i) {
+    const char c = text[i];
+    if (inString) {
+      if (c == '\\') {
+        ++i;
+      } else if (c == '"') {
+        inString = false;
+      }
+      continue;
+    }
+    if (c == '-' && i + 1 < end && text[i + 1] == '>') {
+      // An arrow in a function type, not a closing bracket.
+      ++i;
+      continue;
+    }
+    const int depthBefore = depth;
+    if (c == '"') {
+      inString = true;
+    } else if (c == '(' || c == '<' || c == '{' || c == '[') {
+      ++depth;
+    } else if (c == ')' || c == '>' || c == '}' || c == ']') {
+      --depth;
+    }
+    if (visit(i, depthBefore, depth)) {
+      return i;
+    }
+  }
+  return std::string::npos;
+}
+
+// Returns the position of the bracket which closes the one at `open`.
+size_t findClosing(const std::string &text, size_t open) {
+  const size_t close = scan(text, open, text.size(), [](size_t, int, int depthAfter) { return depthAfter == 0; });
+  if (close == std::string::npos) {
+    throw pjrt::Exception("Unbalanced brackets in StableHLO program.");
+  }
+  return close;
+}
+
+// Splits text[begin, end) at top-level commas.
+std::vector<std::string> splitTopLevel(const std::string &text, size_t begin, size_t end) {
+  std::vector<std::string> parts;
+  size_t partBegin = begin;
+  scan(text, begin, end, [&](size_t position, int depthBefore, int) {
+    if (depthBefore == 0 && text[position] == ',') {
+      parts.push_back(text.substr(partBegin, position - partBegin));
+      partBegin = position + 1;
+    }
+    return false;
+  });
+  const std::string last = trim(text.substr(partBegin, end - partBegin));
+  if (!last.empty() || !parts.empty()) {
+    parts.push_back(last);
+  }
+  return parts;
+}
+
+// Parses "tensor<...> {attributes}".
+Parameter parseTypeAndAttributes(const std::string &text) {
+  const std::string trimmed = trim(text);
+  if (trimmed.rfind("tensor<", 0) != 0) {
+    throw pjrt::Exception("Only tensor arguments and results are supported, got \"" + trimmed + "\".");
+  }
+  const size_t typeEnd = findClosing(trimmed, trimmed.find('<')) + 1;
+  return Parameter{trimmed.substr(0, typeEnd), trim(trimmed.substr(typeEnd))};
+}
+
+// Splits "tensor<128x784xf32>" into "128x784x" and "f32".
+std::pair<std::string, std::string> splitTensorType(const std::string &type) {
+  const std::string contents = type.substr(std::string("tensor<").size(), type.size() - std::string("tensor<").size() - 1);
+  size_t elementBegin = 0;
+  size_t position = 0;
+  while (position < contents.size()) {
+    size_t dimensionEnd = position;
+    while (dimensionEnd < contents.size() && (std::isdigit(static_cast<unsigned char>(contents[dimensionEnd])) || contents[dimensionEnd] == '?')) {
+      ++dimensionEnd;
+    }
+    if (dimensionEnd == position || dimensionEnd >= contents.size() || contents[dimensionEnd] != 'x') {
+      break;
+    }
+    position = dimensionEnd + 1;
+    elementBegin = position;
+  }
+  return {contents.substr(0, elementBegin), contents.substr(elementBegin)};
+}
+
+bool isFloatingPoint(const std::string &elementType) {
+  return elementType == "f16" || elementType == "bf16" || elementType == "f32" || elementType == "f64";
+}
+
+std::string floatLiteral(double value) {
+  std::ostringstream stream;
+  stream << std::scientific << std::setprecision(17) << value;
+  return stream.str();
+}
+
+std::string joinTypes(const std::vector<Parameter> &parameters) {
+  std::string result;
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    result += (i == 0 ? "" : ", ") + parameters[i].type;
+  }
+  return result;
+}
+
+} // namespace
+
+std::string addNormalizingPrologue(const std::string &stableHloProgram, const std::vector<NormalizedArgument> &arguments) {
+  const size_t mainPosition = stableHloProgram.find("@main(");
+  const size_t functionPosition = (mainPosition == std::string::npos ? std::string::npos : stableHloProgram.rfind("func.func", mainPosition));
+  if (functionPosition == std::string::npos) {
+    throw pjrt::Exception("StableHLO program has no @main function.");
+  }
+  const std::string visibility = trim(stableHloProgram.substr(functionPosition + std::string("func.func").size(), mainPosition - functionPosition - std::string("func.func").size()));
+  if (!visibility.empty() && visibility != "public") {
+    throw pjrt::Exception("@main of the StableHLO program must be public.");
+  }
+
+  // Parse the signature of @main.
+  const size_t argumentsOpen = mainPosition + std::string("@main").size();
+  const size_t argumentsClose = findClosing(stableHloProgram, argumentsOpen);
+  std::vector<Parameter> parameters;
+  for (const std::string &argument : splitTopLevel(stableHloProgram, argumentsOpen + 1, argumentsClose)) {
+    const size_t colon = argument.find(':');
+    if (colon == std::string::npos) {
+      throw pjrt::Exception("Cannot parse @main argument \"" + trim(argument) + "\".");
+    }
+    parameters.push_back(parseTypeAndAttributes(argument.substr(colon + 1)));
+  }
+
+  size_t position = skipSpace(stableHloProgram, argumentsClose + 1);
+  if (stableHloProgram.compare(position, 2, "->") != 0) {
+    throw pjrt::Exception("@main of the StableHLO program has no results.");
+  }
+  position = skipSpace(stableHloProgram, position + 2);
+  std::vector<Parameter> results;
+  std::string resultsText;
+  if (stableHloProgram[position] == '(') {
+    const size_t resultsClose = findClosing(stableHloProgram, position);
+    resultsText = stableHloProgram.substr(position, resultsClose + 1 - position);
+    for (const std::string &result : splitTopLevel(stableHloProgram, position + 1, resultsClose)) {
+      results.push_back(parseTypeAndAttributes(result));
+    }
+  } else {
+    const size_t typeClose = findClosing(stableHloProgram, stableHloProgram.find('<', position));
+    resultsText = stableHloProgram.substr(position, typeClose + 1 - position);
+    results.push_back(parseTypeAndAttributes(resultsText));
+  }
+
+  // Build the new @main.
+  std::vector<std::string> outerParameters(parameters.size());
+  std::vector<std::string> innerOperands(parameters.size());
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    outerParameters[i] = "%arg" + std::to_string(i) + ": " + parameters[i].type + (parameters[i].attributes.empty() ? "" : " " + parameters[i].attributes);
+    innerOperands[i] = "%arg" + std::to_string(i);
+  }
+
+  std::string body;
+  for (const NormalizedArgument &argument : arguments) {
+    if (argument.index >= parameters.size()) {
+      throw pjrt::Exception("Normalized argument index " + std::to_string(argument.index) + " is out of range for @main with " + std::to_string(parameters.size()) + " arguments.");
+    }
+    const std::string index = std::to_string(argument.index);
+    const std::string &type = parameters[argument.index].type;
+    const auto [dimensions, elementType] = splitTensorType(type);
+    const std::string storageType = "tensor<" + dimensions + detail::mlirElementType(argument.storageType) + ">";
+    // Argument attributes, e.g. buffer donation, describe the original type and are dropped.
+    outerParameters[argument.index] = "%arg" + index + ": " + storageType;
+
+    body += "    %converted" + index + " = stablehlo.convert %arg" + index + " : (" + storageType + ") -> " + type + "\n";
+    innerOperands[argument.index] = "%converted" + index;
+    if (argument.scale != 1.0) {
+      if (!isFloatingPoint(elementType)) {
+        throw pjrt::Exception("Argument " + index + " of @main has element type " + elementType + "; only floating point arguments can be scaled.");
+      }
+      body += "    %scale" + index + " = stablehlo.constant dense<" + floatLiteral(argument.scale) + "> : " + type + "\n";
+      body += "    %normalized" + index + " = stablehlo.multiply %converted" + index + ", %scale" + index + " : " + type + "\n";
+      innerOperands[argument.index] = "%normalized" + index;
+    }
+  }
+
+  std::string operands;
+  std::string outerSignature;
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    operands += (i == 0 ? "" : ", ") + innerOperands[i];
+    outerSignature += (i == 0 ? "" : ", ") + outerParameters[i];
+  }
+  const std::string resultTypes = joinTypes(results);
+  std::string returnValues;
+  if (results.size() == 1) {
+    body += "    %results = func.call @main_inner(" + operands + ") : (" + joinTypes(parameters) + ") -> " + resultTypes + "\n";
+    returnValues = "%results";
+  } else {
+    body += "    %results:" + std::to_string(results.size()) + " = func.call @main_inner(" + operands + ") : (" + joinTypes(parameters) + ") -> (" + resultTypes + ")\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+      returnValues += (i == 0 ? "" : ", ") + std::string("%results#") + std::to_string(i);
+    }
+  }
+
+  const std::string outerMain =
+      "  func.func public @main(" + outerSignature + ") -> " + resultsText + " {\n" +
+      body +
+      "    return " + returnValues + " : " + resultTypes + "\n"
+      "  }\n";
+
+  // Rename the original @main and append the new one at the end of the module.
+  const size_t moduleClose = stableHloProgram.rfind('}');
+  std::string program = stableHloProgram.substr(0, functionPosition);
+  program += "func.func private @main_inner";
+  program += stableHloProgram.substr(argumentsOpen, moduleClose - argumentsOpen);
+  program += outerMain;
+  // XLA fails to parse programs which end in a newline, so keep whatever followed the module as it was.
+  program += stableHloProgram.substr(moduleClose);
+  return program;
+}
+
+} // namespace pjrt
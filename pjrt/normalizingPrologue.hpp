@@ -0,0 +1,43 @@
+#ifndef PJRT_NORMALIZING_PROLOGUE_HPP_
+#define PJRT_NORMALIZING_PROLOGUE_HPP_
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace pjrt {
+
+// An argument of a program which should be transferred in a compact storage type and normalized on the device.
+struct NormalizedArgument {
+  // Position of the argument in the program's @main.
+  size_t index;
+  // Element type of the buffer which is passed for this argument instead, e.g. raw pixels as U8.
+  PJRT_Buffer_Type storageType{PJRT_Buffer_Type_U8};
+  // The stored values are converted to the argument's original element type and multiplied by this. Only floating point
+  // arguments may use a scale other than 1.
+  double scale{1.0};
+};
+
+// Wraps a StableHLO program's @main with a prologue which converts and scales the given arguments on the device.
+//
+// The original @main is renamed to a private @main_inner and a new public @main calls it. The new @main takes every
+// argument in `arguments` with its storage type and shape; all other arguments and all results are unchanged.
+// For example, an image batch of f32 in [0, 1] can be uploaded as u8 with a scale of 1/255, moving a quarter of the bytes.
+// Throws pjrt::Exception if @main cannot be found or understood.
+std::string addNormalizingPrologue(const std::string &stableHloProgram, const std::vector<NormalizedArgument> &arguments);
+
+} // namespace pjrt
+
+#endif // PJRT_NORMALIZING_PROLOGUE_HPP_
@@ -0,0 +1,179 @@
+#include "offloadManager.hpp"
+#include "deviceView.hpp"
+#include "exception.hpp"
+#include "loadedExecutable.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace pjrt {
+
+namespace {
+
+// Prefers pinned host memory, which devices can DMA to and from directly.
+std::optional<MemoryView> findHostMemory(const DeviceView &device) {
+  std::optional<MemoryView> unpinned;
+  for (MemoryView &memory : device.addressableMemories()) {
+    const std::string kind = memory.kind();
+    if (kind == "pinned_host") {
+      return std::optional<MemoryView>(std::move(memory));
+    }
+    if (kind == "unpinned_host" && !unpinned) {
+      unpinned.emplace(std::move(memory));
+    }
+  }
+  return unpinned;
+}
+
+} // namespace
+
+OffloadManager::OffloadManager(const DeviceView &device, size_t deviceBudgetBytes) :
+    device_(device), deviceBudgetBytes_(deviceBudgetBytes), deviceMemory_(device.defaultMemory()), hostMemory_(findHostMemory(device)) {
+  if (!hostMemory_) {
+    throw pjrt::Exception("OffloadManager: device \"" + device.description() + "\" has no host memory space to offload to.");
+  }
+}
+
+OffloadManager::Id OffloadManager::add(Buffer &&buffer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const size_t sizeInBytes = buffer.onDeviceSizeInBytes();
+  makeRoom(sizeInBytes, {});
+
+  const Id id = nextId_++;
+  Entry &added = entries_[id];
+  added.buffer.emplace(std::move(buffer));
+  added.sizeInBytes = sizeInBytes;
+  added.lruPosition = lru_.insert(lru_.end(), id);
+  ++stats_.residentBuffers;
+  stats_.residentBytes += sizeInBytes;
+  return id;
+}
+
+Buffer OffloadManager::remove(Id id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  acquireLocked({id});
+  Entry &removed = entry(id);
+  Buffer buffer(std::move(*removed.buffer));
+  lru_.erase(removed.lruPosition);
+  --stats_.residentBuffers;
+  stats_.residentBytes -= removed.sizeInBytes;
+  entries_.erase(id);
+  return buffer;
+}
+
+std::vector<Buffer*> OffloadManager::acquire(const std::vector<Id> &ids) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return acquireLocked(ids);
+}
+
+std::future<std::vector<Buffer>> OffloadManager::execute(LoadedExecutable &executable, const std::vector<Id> &ids) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<Buffer*> arguments = acquireLocked(ids);
+  // Once launched, swapping an argument out only copies it, which PJRT orders after the execution's use of it.
+  return executable.execute(device_, arguments, /*allowDonation=*/false);
+}
+
+bool OffloadManager::isResident(Id id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entry(id).resident;
+}
+
+OffloadManager::Stats OffloadManager::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+OffloadManager::Entry& OffloadManager::entry(Id id) {
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    throw pjrt::Exception("OffloadManager: unknown buffer id " + std::to_string(id) + ".");
+  }
+  return it->second;
+}
+
+const OffloadManager::Entry& OffloadManager::entry(Id id) const {
+  auto it = entries_.find(id);
+  if (it == entries_.end()) {
+    throw pjrt::Exception("OffloadManager: unknown buffer id " + std::to_string(id) + ".");
+  }
+  return it->second;
+}
+
+std::vector<Buffer*> OffloadManager::acquireLocked(const std::vector<Id> &ids) {
+  // Only the buffers which are offloaded need room, and none of the requested buffers may be evicted to make it.
+  std::vector<Id> uniqueIds(ids);
+  std::sort(uniqueIds.begin(), uniqueIds.end());
+  uniqueIds.erase(std::unique(uniqueIds.begin(), uniqueIds.end()), uniqueIds.end());
+  size_t incomingBytes = 0;
+  for (Id id : uniqueIds) {
+    const Entry &requested = entry(id);
+    if (!requested.resident) {
+      incomingBytes += requested.sizeInBytes;
+    }
+  }
+  makeRoom(incomingBytes, ids);
+
+  std::vector<Buffer*> buffers;
+  buffers.reserve(ids.size());
+  for (Id id : ids) {
+    Entry &requested = entry(id);
+    if (!requested.resident) {
+      swapIn(requested);
+      requested.lruPosition = lru_.insert(lru_.end(), id);
+    } else {
+      lru_.splice(lru_.end(), lru_, requested.lruPosition);
+    }
+    buffers.push_back(&*requested.buffer);
+  }
+  return buffers;
+}
+
+void OffloadManager::makeRoom(size_t incomingBytes, const std::vector<Id> &keep) {
+  auto it = lru_.begin();
+  while (stats_.residentBytes + incomingBytes > deviceBudgetBytes_ && it != lru_.end()) {
+    const Id id = *it;
+    ++it;
+    if (std::find(keep.begin(), keep.end(), id) != keep.end()) {
+      continue;
+    }
+    swapOut(entry(id));
+  }
+}
+
+void OffloadManager::swapOut(Entry &evicted) {
+  const auto start = std::chrono::steady_clock::now();
+  Buffer hostCopy = evicted.buffer->copyToMemory(*hostMemory_);
+  // Waiting surfaces copy errors while the device copy still exists, and lets the device copy be destroyed right away.
+  hostCopy.awaitReady();
+  // Destroyed rather than dropped: with a DeferredReleaseQueue attached, a dropped buffer is only freed later on the queue's
+  // thread, while the budget counts its memory as free from here on.
+  evicted.buffer->destroy();
+  evicted.buffer.emplace(std::move(hostCopy));
+  stats_.swapOutTime += std::chrono::steady_clock::now() - start;
+
+  evicted.resident = false;
+  lru_.erase(evicted.lruPosition);
+  ++stats_.swapOuts;
+  --stats_.residentBuffers;
+  stats_.residentBytes -= evicted.sizeInBytes;
+  ++stats_.offloadedBuffers;
+  stats_.offloadedBytes += evicted.sizeInBytes;
+}
+
+void OffloadManager::swapIn(Entry &offloaded) {
+  const auto start = std::chrono::steady_clock::now();
+  Buffer deviceCopy = offloaded.buffer->copyToMemory(deviceMemory_);
+  deviceCopy.awaitReady();
+  offloaded.buffer.emplace(std::move(deviceCopy));
+  stats_.swapInTime += std::chrono::steady_clock::now() - start;
+
+  offloaded.resident = true;
+  ++stats_.swapIns;
+  ++stats_.residentBuffers;
+  stats_.residentBytes += offloaded.sizeInBytes;
+  --stats_.offloadedBuffers;
+  stats_.offloadedBytes -= offloaded.sizeInBytes;
+}
+
+} // namespace pjrt
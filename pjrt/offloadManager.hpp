@@ -0,0 +1,102 @@
+#ifndef PJRT_OFFLOAD_MANAGER_HPP_
+#define PJRT_OFFLOAD_MANAGER_HPP_
+
+#include "buffer.hpp"
+#include "memoryView.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace pjrt {
+
+class DeviceView;
+class LoadedExecutable;
+
+// Keeps a set of buffers, e.g. the weights of several models, within a device memory budget by moving the least recently
+// used ones to the device's host memory space ("pinned_host", or "unpinned_host" if that is all there is) and back.
+//
+// Buffers are handed to the manager with add() and referred to by the returned Id from then on. Any access through the
+// manager swaps the buffer back into device memory if needed and marks it as most recently used. Swapping out happens
+// whenever making room is necessary to stay within the budget; if the buffers needed at once exceed the budget on their
+// own, the budget is exceeded rather than failing.
+//
+// `device` must outlive the manager. Thread-safe; swaps are performed while holding the manager's lock.
+class OffloadManager {
+public:
+  using Id = uint64_t;
+
+  struct Stats {
+    uint64_t swapIns{0};
+    uint64_t swapOuts{0};
+    // Wall time spent waiting for swaps to complete.
+    std::chrono::nanoseconds swapInTime{0};
+    std::chrono::nanoseconds swapOutTime{0};
+    size_t residentBuffers{0};
+    size_t residentBytes{0};
+    size_t offloadedBuffers{0};
+    size_t offloadedBytes{0};
+  };
+
+  // Throws if `device` has no host memory space.
+  OffloadManager(const DeviceView &device, size_t deviceBudgetBytes);
+
+  // Takes ownership of `buffer`, which must live in the device's default memory. It becomes the most recently used buffer.
+  Id add(Buffer &&buffer);
+
+  // Gives up management of `id` and returns its buffer, in device memory.
+  Buffer remove(Id id);
+
+  // Makes sure every buffer in `ids` is in device memory and marks them as most recently used.
+  // The returned pointers are in the order of `ids` and stay valid until the next call into the manager.
+  std::vector<Buffer*> acquire(const std::vector<Id> &ids);
+
+  // Acquires `ids` and executes `executable` with them as arguments. Managed buffers are never donated.
+  // Since the arguments are swapped in under the same lock which launches the execution, no other thread can swap them out in between.
+  std::future<std::vector<Buffer>> execute(LoadedExecutable &executable, const std::vector<Id> &ids);
+
+  bool isResident(Id id) const;
+
+  Stats stats() const;
+private:
+  struct Entry {
+    // In device memory if `resident`, otherwise in host memory.
+    std::optional<Buffer> buffer;
+    bool resident{true};
+    size_t sizeInBytes{0};
+    // Position in lru_, only meaningful while resident.
+    std::list<Id>::iterator lruPosition;
+  };
+
+  Entry& entry(Id id);
+  const Entry& entry(Id id) const;
+
+  // Swaps in every buffer of `ids` which is offloaded and moves all of them to the hot end of lru_. Requires mutex_.
+  std::vector<Buffer*> acquireLocked(const std::vector<Id> &ids);
+  // Swaps out least recently used buffers which are not in `keep` until `incomingBytes` more fit into the budget. Requires mutex_.
+  void makeRoom(size_t incomingBytes, const std::vector<Id> &keep);
+  void swapOut(Entry &entry);
+  void swapIn(Entry &entry);
+
+  const DeviceView &device_;
+  const size_t deviceBudgetBytes_;
+  MemoryView deviceMemory_;
+  std::optional<MemoryView> hostMemory_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<Id, Entry> entries_;
+  // Resident buffers, from least to most recently used.
+  std::list<Id> lru_;
+  Id nextId_{0};
+  Stats stats_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_OFFLOAD_MANAGER_HPP_
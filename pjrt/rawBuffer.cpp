@@ -0,0 +1,194 @@
+#include "rawBuffer.hpp"
+#include "buffer.hpp"
+#include "context.hpp"
+#include "detail/callbackUserData.hpp"
+#include "detail/hostMirror.hpp"
+#include "detail/rawBufferExtension.hpp"
+#include "event.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wchanges-meaning"
+#endif
+
+// Assume pjrt_c_api.h is in the same directory or an include path
+#include "pjrt_c_api.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace pjrt {
+
+namespace {
+
+const PJRT_RawBuffer_Extension* findRawBufferExtension(const Context &context) {
+  const PJRT_Extension_Base *extension = context.findExtension(PJRT_Extension_Type_RawBuffer);
+  if (extension == nullptr || extension->struct_size < detail::kMinimumRawBufferExtensionSize) {
+    return nullptr;
+  }
+  return reinterpret_cast<const PJRT_RawBuffer_Extension*>(extension);
+}
+
+void awaitBufferReady(const Context &context, PJRT_Buffer *buffer) {
+  PJRT_Buffer_ReadyEvent_Args args;
+  args.struct_size = PJRT_Buffer_ReadyEvent_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer;
+  PJRT_Error* pjrtError = context.pjrtApi_->PJRT_Buffer_ReadyEvent(&args);
+  if (pjrtError != nullptr) {
+    throw context.convertPjrtErrorToException(pjrtError, "PJRT_Buffer_ReadyEvent", __FILE__, __LINE__);
+  }
+  Event event(context, args.event);
+  event.wait();
+}
+
+// Kept alive by a write's callback data, so that the host mirror counts the write as in flight until PJRT completes it.
+struct WriteInFlight {
+  explicit WriteInFlight(std::shared_ptr<detail::HostMirror> hostMirror) : mirror(std::move(hostMirror)) { mirror->beginWrite(); }
+  WriteInFlight(const WriteInFlight &) = delete;
+  WriteInFlight& operator=(const WriteInFlight &) = delete;
+  ~WriteInFlight() { mirror->endWrite(); }
+
+  const std::shared_ptr<detail::HostMirror> mirror;
+};
+
+} // namespace
+
+RawBuffer::RawBuffer(const Buffer &buffer) : context_(buffer.context_), extension_(findRawBufferExtension(buffer.context_)), buffer_(buffer.c_buffer()), hostMirror_(buffer.hostMirror()) {
+  if (extension_ == nullptr) {
+    throw pjrt::Exception("The PJRT plugin does not support the RawBuffer extension.");
+  }
+  PJRT_RawBuffer_CreateRawAliasOfBuffer_Args args;
+  args.struct_size = PJRT_RawBuffer_CreateRawAliasOfBuffer_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = buffer_;
+  PJRT_Error* pjrtError = extension_->PJRT_RawBuffer_CreateRawAliasOfBuffer(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_RawBuffer_CreateRawAliasOfBuffer", __FILE__, __LINE__);
+  }
+  rawBuffer_ = args.raw_buffer;
+}
+
+RawBuffer::RawBuffer(RawBuffer &&other) : context_(other.context_), extension_(other.extension_), buffer_(other.buffer_), rawBuffer_(other.rawBuffer_), hostMirror_(std::move(other.hostMirror_)) {
+  other.buffer_ = nullptr;
+  other.rawBuffer_ = nullptr;
+}
+
+RawBuffer& RawBuffer::operator=(RawBuffer &&other) {
+  assert(((void)"Cannot assign a RawBuffer from one context to another", &other.context_ == &context_));
+  if (this != &other) {
+    destroy();
+    extension_ = other.extension_;
+    buffer_ = other.buffer_;
+    rawBuffer_ = other.rawBuffer_;
+    hostMirror_ = std::move(other.hostMirror_);
+    other.buffer_ = nullptr;
+    other.rawBuffer_ = nullptr;
+  }
+  return *this;
+}
+
+RawBuffer::~RawBuffer() {
+  if (rawBuffer_ == nullptr) {
+    return;
+  }
+  PJRT_RawBuffer_Destroy_Args args;
+  args.struct_size = PJRT_RawBuffer_Destroy_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = rawBuffer_;
+  PJRT_Error* pjrtError = extension_->PJRT_RawBuffer_Destroy(&args);
+  if (pjrtError != nullptr) {
+    const pjrt::Exception ex = context_.convertPjrtErrorToException(pjrtError, "PJRT_RawBuffer_Destroy", __FILE__, __LINE__);
+    std::cerr << "pjrt::RawBuffer destructor failed to destroy PJRT_RawBuffer: \"" << ex.what() << "\"" << std::endl;
+  }
+}
+
+void RawBuffer::destroy() {
+  if (rawBuffer_ == nullptr) {
+    return;
+  }
+  PJRT_RawBuffer_Destroy_Args args;
+  args.struct_size = PJRT_RawBuffer_Destroy_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = rawBuffer_;
+  PJRT_Error* pjrtError = extension_->PJRT_RawBuffer_Destroy(&args);
+  rawBuffer_ = nullptr;
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_RawBuffer_Destroy", __FILE__, __LINE__);
+  }
+}
+
+bool RawBuffer::isSupported(const Context &context) {
+  return findRawBufferExtension(context) != nullptr;
+}
+
+size_t RawBuffer::onDeviceSizeInBytes() const {
+  PJRT_RawBuffer_GetOnDeviceSizeInBytes_Args args;
+  args.struct_size = PJRT_RawBuffer_GetOnDeviceSizeInBytes_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = rawBuffer_;
+  PJRT_Error* pjrtError = extension_->PJRT_RawBuffer_GetOnDeviceSizeInBytes(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_RawBuffer_GetOnDeviceSizeInBytes", __FILE__, __LINE__);
+  }
+  return args.on_device_size_in_bytes;
+}
+
+std::future<void> RawBuffer::write(const void *source, int64_t offset, int64_t transferSize, const std::vector<const Buffer*> &after) {
+  checkRange(offset, transferSize);
+
+  // Fence: the buffer's contents must be defined, and earlier readers must be done, before bytes are overwritten.
+  awaitBufferReady(context_, buffer_);
+  for (const Buffer *buffer : after) {
+    awaitBufferReady(context_, buffer->c_buffer());
+  }
+  std::shared_ptr<const WriteInFlight> writeInFlight = std::make_shared<const WriteInFlight>(hostMirror_);
+
+  PJRT_RawBuffer_CopyRawHostToDevice_Args args;
+  args.struct_size = PJRT_RawBuffer_CopyRawHostToDevice_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = rawBuffer_;
+  args.src = source;
+  args.offset = offset;
+  args.transfer_size = transferSize;
+  PJRT_Error* pjrtError = extension_->PJRT_RawBuffer_CopyRawHostToDevice(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_RawBuffer_CopyRawHostToDevice", __FILE__, __LINE__);
+  }
+  std::unique_ptr<detail::CallbackUserData<void>> callbackUserData = std::make_unique<detail::CallbackUserData<void>>(context_);
+  callbackUserData->keepAlive(std::move(writeInFlight));
+  return context_.getFutureForEvent(args.event, std::move(callbackUserData));
+}
+
+std::future<void> RawBuffer::read(void *destination, int64_t offset, int64_t transferSize) const {
+  checkRange(offset, transferSize);
+  awaitBufferReady(context_, buffer_);
+
+  PJRT_RawBuffer_CopyRawDeviceToHost_Args args;
+  args.struct_size = PJRT_RawBuffer_CopyRawDeviceToHost_Args_STRUCT_SIZE;
+  args.extension_start = nullptr;
+  args.buffer = rawBuffer_;
+  args.dst = destination;
+  args.offset = offset;
+  args.transfer_size = transferSize;
+  PJRT_Error* pjrtError = extension_->PJRT_RawBuffer_CopyRawDeviceToHost(&args);
+  if (pjrtError != nullptr) {
+    throw context_.convertPjrtErrorToException(pjrtError, "PJRT_RawBuffer_CopyRawDeviceToHost", __FILE__, __LINE__);
+  }
+  return context_.getFutureForEvent(args.event, std::make_unique<detail::CallbackUserData<void>>(context_));
+}
+
+void RawBuffer::checkRange(int64_t offset, int64_t transferSize) const {
+  if (offset < 0 || transferSize < 0 || static_cast<size_t>(offset + transferSize) > onDeviceSizeInBytes()) {
+    throw pjrt::Exception("Raw buffer range [" + std::to_string(offset) + ", " + std::to_string(offset + transferSize) + ") is out of bounds.");
+  }
+}
+
+} // namespace pjrt
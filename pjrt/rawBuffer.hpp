@@ -0,0 +1,71 @@
+#ifndef PJRT_RAW_BUFFER_HPP_
+#define PJRT_RAW_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+struct PJRT_Buffer;
+struct PJRT_RawBuffer;
+struct PJRT_RawBuffer_Extension;
+
+namespace pjrt {
+
+namespace detail {
+struct HostMirror;
+} // namespace detail
+
+class Buffer;
+class Context;
+
+// Byte-level access to the device memory of an existing Buffer, through the plugin's experimental RawBuffer extension.
+// Writes update the Buffer in place, e.g. to change a few rows of a large device-resident table without re-uploading it.
+//
+// The aliased Buffer must outlive the RawBuffer and must not be moved from while it is in use. Offsets and sizes are in
+// bytes of the on-device representation, which for dense buffers in the default layout matches the host representation.
+class RawBuffer {
+public:
+  // Throws if the plugin does not support the RawBuffer extension.
+  explicit RawBuffer(const Buffer &buffer);
+  RawBuffer(RawBuffer &&other);
+  RawBuffer& operator=(RawBuffer &&other);
+  ~RawBuffer();
+
+  void destroy();
+
+  // Returns whether the plugin supports the RawBuffer extension.
+  static bool isSupported(const Context &context);
+
+  size_t onDeviceSizeInBytes() const;
+
+  // Asynchronously copies `transferSize` bytes from `source` into the buffer, starting at byte `offset`.
+  //
+  // PJRT does not order raw writes against executions. Before issuing the copy, this blocks until the buffer is ready and
+  // until every buffer in `after` is ready. Pass the outputs of in-flight executions which read the buffer, so that they
+  // observe the old contents. `source` must stay alive until the future is ready.
+  // The aliased Buffer's host mirror, see Buffer::mirroredToHost(), is dropped when the copy is issued and again when it
+  // completes, and is not refilled in between.
+  std::future<void> write(const void *source, int64_t offset, int64_t transferSize, const std::vector<const Buffer*> &after = {});
+
+  // Asynchronously copies `transferSize` bytes starting at byte `offset` into `destination`, once the buffer is ready.
+  // `destination` must stay alive until the future is ready.
+  std::future<void> read(void *destination, int64_t offset, int64_t transferSize) const;
+public:
+// private:
+  const Context &context_;
+  const PJRT_RawBuffer_Extension *extension_{nullptr};
+  PJRT_Buffer *buffer_{nullptr};
+  PJRT_RawBuffer *rawBuffer_{nullptr};
+  // The aliased Buffer's host mirror slot, created along with the RawBuffer so that write() also sees a mirror which is first
+  // filled later. The slot alone is a few words; it holds no readback until Buffer::mirroredToHost().
+  std::shared_ptr<detail::HostMirror> hostMirror_;
+
+private:
+  void checkRange(int64_t offset, int64_t transferSize) const;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_RAW_BUFFER_HPP_
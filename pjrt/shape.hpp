@@ -0,0 +1,89 @@
+#ifndef PJRT_SHAPE_HPP_
+#define PJRT_SHAPE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <vector>
+
+namespace pjrt {
+
+// The dimensions of an array. Shapes of up to kInlineCapacity dimensions are stored inline, so creating, copying and
+// comparing them never allocates. Larger shapes are supported, but spill to the heap.
+//
+// Converts implicitly from braced lists and from std::vector<int64_t>, so `{2, 3}` and existing vectors can be passed
+// wherever a Shape is expected.
+class Shape {
+public:
+  static constexpr size_t kInlineCapacity = 8;
+
+  Shape() = default;
+  Shape(std::initializer_list<int64_t> dims) : Shape(dims.begin(), dims.size()) {}
+  Shape(const std::vector<int64_t> &dims) : Shape(dims.data(), dims.size()) {}
+  Shape(const int64_t *dims, size_t rank) : rank_(rank) {
+    if (rank_ > kInlineCapacity) {
+      heap_.assign(dims, dims + rank);
+    } else {
+      std::copy(dims, dims + rank, inline_);
+    }
+  }
+
+  size_t size() const { return rank_; }
+  bool empty() const { return rank_ == 0; }
+
+  const int64_t* data() const { return (rank_ > kInlineCapacity ? heap_.data() : inline_); }
+  int64_t* data() { return (rank_ > kInlineCapacity ? heap_.data() : inline_); }
+  const int64_t* begin() const { return data(); }
+  const int64_t* end() const { return data() + rank_; }
+  int64_t* begin() { return data(); }
+  int64_t* end() { return data() + rank_; }
+  int64_t operator[](size_t index) const { return data()[index]; }
+  int64_t& operator[](size_t index) { return data()[index]; }
+
+  void push_back(int64_t dim) {
+    if (rank_ < kInlineCapacity) {
+      inline_[rank_++] = dim;
+      return;
+    }
+    if (rank_ == kInlineCapacity) {
+      heap_.assign(inline_, inline_ + kInlineCapacity);
+    }
+    heap_.push_back(dim);
+    ++rank_;
+  }
+
+  // Product of the dimensions; 1 for a scalar.
+  int64_t numElements() const {
+    int64_t count = 1;
+    for (int64_t dim : *this) {
+      count *= dim;
+    }
+    return count;
+  }
+
+  std::vector<int64_t> toVector() const { return std::vector<int64_t>(begin(), end()); }
+
+  friend bool operator==(const Shape &lhs, const Shape &rhs) { return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+  friend bool operator!=(const Shape &lhs, const Shape &rhs) { return !(lhs == rhs); }
+  friend bool operator<(const Shape &lhs, const Shape &rhs) { return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); }
+
+  // Prints e.g. "[2, 3]".
+  friend std::ostream& operator<<(std::ostream &os, const Shape &shape) {
+    os << '[';
+    for (size_t i = 0; i < shape.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << shape[i];
+    }
+    return os << ']';
+  }
+private:
+  size_t rank_{0};
+  int64_t inline_[kInlineCapacity]{};
+  // Only used when rank_ > kInlineCapacity.
+  std::vector<int64_t> heap_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_SHAPE_HPP_
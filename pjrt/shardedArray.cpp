@@ -0,0 +1,75 @@
+#include "shardedArray.hpp"
+
+#include <sstream>
+#include <string>
+
+namespace pjrt {
+
+Shape ShardingSpec::shardShape(const Shape &globalShape, size_t numShards) const {
+  if (isReplicated()) {
+    return globalShape;
+  }
+  if (*axis_ >= globalShape.size()) {
+    throw pjrt::Exception("Cannot split an array of rank " + std::to_string(globalShape.size()) + " along axis " + std::to_string(*axis_) + ".");
+  }
+  if (numShards == 0 || globalShape[*axis_] % static_cast<int64_t>(numShards) != 0) {
+    std::ostringstream message;
+    message << "Cannot split shape " << globalShape << " into " << numShards << " equal shards along axis " << *axis_ << ".";
+    throw pjrt::Exception(message.str());
+  }
+  Shape shape = globalShape;
+  shape[*axis_] /= static_cast<int64_t>(numShards);
+  return shape;
+}
+
+Shape ShardingSpec::globalShape(const Shape &shardShape, size_t numShards) const {
+  if (isReplicated()) {
+    return shardShape;
+  }
+  if (*axis_ >= shardShape.size()) {
+    throw pjrt::Exception("Cannot split an array of rank " + std::to_string(shardShape.size()) + " along axis " + std::to_string(*axis_) + ".");
+  }
+  Shape shape = shardShape;
+  shape[*axis_] *= static_cast<int64_t>(numShards);
+  return shape;
+}
+
+ShardedArray::ShardedArray(const ShardingSpec &sharding, std::vector<Buffer> &&shards) : sharding_(sharding), shards_(std::move(shards)) {
+  if (shards_.empty()) {
+    throw pjrt::Exception("A ShardedArray needs at least one shard.");
+  }
+  for (const Buffer &shard : shards_) {
+    if (shard.dimensions() != shards_.front().dimensions()) {
+      std::ostringstream message;
+      message << "Shards of one ShardedArray must have the same shape, got " << shards_.front().dimensions() << " and " << shard.dimensions() << ".";
+      throw pjrt::Exception(message.str());
+    }
+  }
+  shape_ = sharding_.globalShape(shards_.front().dimensions(), shards_.size());
+}
+
+std::vector<int64_t> ShardedArray::rowMajorByteStrides(const Shape &shape, size_t elementSize) {
+  std::vector<int64_t> strides(shape.size());
+  int64_t stride = static_cast<int64_t>(elementSize);
+  for (size_t i = shape.size(); i-- > 0;) {
+    strides[i] = stride;
+    stride *= shape[i];
+  }
+  return strides;
+}
+
+ShardedArray::SplitLayout ShardedArray::splitLayout(const Shape &globalShape, const ShardingSpec &sharding, size_t numShards) {
+  SplitLayout layout{1, 1, 1};
+  for (size_t i = 0; i < globalShape.size(); ++i) {
+    const size_t dim = static_cast<size_t>(globalShape[i]);
+    if (i < sharding.axis()) {
+      layout.outer *= dim;
+    } else {
+      layout.globalBlock *= dim;
+    }
+  }
+  layout.shardBlock = layout.globalBlock / numShards;
+  return layout;
+}
+
+} // namespace pjrt
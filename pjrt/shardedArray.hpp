@@ -0,0 +1,175 @@
+#ifndef PJRT_SHARDED_ARRAY_HPP_
+#define PJRT_SHARDED_ARRAY_HPP_
+
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/detail/types.hpp"
+#include "pjrt/deviceView.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/shape.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace pjrt {
+
+// How the global shape of a ShardedArray is divided between its devices.
+class ShardingSpec {
+public:
+  // Every device holds the whole array, e.g. model weights in data-parallel training.
+  static ShardingSpec replicated() { return ShardingSpec(std::nullopt); }
+  // Device i holds the i-th of equally sized slices along `axis`, e.g. axis 0 to split a batch.
+  static ShardingSpec split(size_t axis) { return ShardingSpec(axis); }
+
+  bool isReplicated() const { return !axis_.has_value(); }
+  // The split axis. Only meaningful if !isReplicated().
+  size_t axis() const { return axis_.value_or(0); }
+
+  // The shape each of `numShards` devices holds. Throws if the split axis does not exist or is not divisible by `numShards`.
+  Shape shardShape(const Shape &globalShape, size_t numShards) const;
+  // The shape of the whole array, given the shape of one of its `numShards` shards.
+  Shape globalShape(const Shape &shardShape, size_t numShards) const;
+
+  friend bool operator==(const ShardingSpec &lhs, const ShardingSpec &rhs) { return lhs.axis_ == rhs.axis_; }
+  friend bool operator!=(const ShardingSpec &lhs, const ShardingSpec &rhs) { return !(lhs == rhs); }
+private:
+  explicit ShardingSpec(std::optional<size_t> axis) : axis_(axis) {}
+
+  std::optional<size_t> axis_;
+};
+
+// One logical array stored as one Buffer per device, for data-parallel work.
+// Shard i lives on device i of the list the array was uploaded to, or of the executable which produced it. Pass ShardedArrays
+// to LoadedExecutable::execute() to launch a program compiled for several replicas with each device's shards.
+class ShardedArray {
+public:
+  // Takes ownership of one shard per device, in device order. Throws if the shards do not all have the same shape.
+  ShardedArray(const ShardingSpec &sharding, std::vector<Buffer> &&shards);
+
+  // Uploads `data`, a dense row-major array of `globalShape`, to `devices`. The transfers to all devices run concurrently,
+  // and each reads its slice of `data` in place through byte strides, so nothing is packed on the host first.
+  // `data` must stay alive until the future is ready. The future is deferred: get() waits for the transfers and assembles
+  // the array in the calling thread.
+  template <typename T>
+  static std::future<ShardedArray> upload(const Client &client, const T *data, const Shape &globalShape, const ShardingSpec &sharding, const std::vector<DeviceView> &devices);
+
+  // Shape of the whole array.
+  const Shape& shape() const { return shape_; }
+  const ShardingSpec& sharding() const { return sharding_; }
+  size_t numShards() const { return shards_.size(); }
+
+  Buffer& shard(size_t index) { return shards_[index]; }
+  const Buffer& shard(size_t index) const { return shards_[index]; }
+  const std::vector<Buffer>& shards() const { return shards_; }
+  // Gives up ownership of the shards. This ShardedArray is left without any.
+  std::vector<Buffer> releaseShards() { return std::move(shards_); }
+
+  // Copies the whole array to the host as a dense row-major array. The copies from all devices are issued at once; for a
+  // replicated array only the first shard is read. Like upload(), the future is deferred. Throws if T does not match the
+  // element type.
+  template <typename T>
+  std::future<std::vector<T>> toHost() const;
+// private:
+  ShardingSpec sharding_;
+  Shape shape_;
+  std::vector<Buffer> shards_;
+
+private:
+  // Byte strides of a dense row-major array of `shape`.
+  static std::vector<int64_t> rowMajorByteStrides(const Shape &shape, size_t elementSize);
+
+  // Number of elements in one row of the split axis and everything after it, and in the part of it one shard holds.
+  // Row-major data is laid out as `outer` blocks of `globalBlock` elements, of which each shard holds `shardBlock`.
+  struct SplitLayout {
+    size_t outer;
+    size_t globalBlock;
+    size_t shardBlock;
+  };
+  static SplitLayout splitLayout(const Shape &globalShape, const ShardingSpec &sharding, size_t numShards);
+};
+
+template <typename T>
+std::future<ShardedArray> ShardedArray::upload(const Client &client, const T *data, const Shape &globalShape, const ShardingSpec &sharding, const std::vector<DeviceView> &devices) {
+  if (devices.empty()) {
+    throw pjrt::Exception("A ShardedArray needs at least one device.");
+  }
+  const Shape shardShape = sharding.shardShape(globalShape, devices.size());
+
+  std::vector<std::future<Buffer>> transfers;
+  transfers.reserve(devices.size());
+  if (sharding.isReplicated()) {
+    for (const DeviceView &device : devices) {
+      transfers.push_back(client.transferToDevice(data, shardShape, device));
+    }
+  } else {
+    // Each shard is a strided view of the global array, starting at its first slice along the split axis.
+    const std::vector<int64_t> byteStrides = rowMajorByteStrides(globalShape, sizeof(T));
+    const size_t shardBlock = splitLayout(globalShape, sharding, devices.size()).shardBlock;
+    for (size_t i = 0; i < devices.size(); ++i) {
+      transfers.push_back(client.transferToDevice(data + i * shardBlock, shardShape, byteStrides, devices[i]));
+    }
+  }
+
+  return std::async(std::launch::deferred, [sharding, transfers = std::move(transfers)]() mutable {
+    std::vector<Buffer> shards;
+    shards.reserve(transfers.size());
+    for (std::future<Buffer> &transfer : transfers) {
+      shards.push_back(transfer.get());
+    }
+    return ShardedArray(sharding, std::move(shards));
+  });
+}
+
+template <typename T>
+std::future<std::vector<T>> ShardedArray::toHost() const {
+  if (shards_.empty()) {
+    throw pjrt::Exception("toHost() called on a ShardedArray without shards.");
+  }
+  if (shards_.front().elementType() != detail::TypeToPjrtBufferType<T>()) {
+    throw pjrt::Exception("toHost() called with a type which does not match the ShardedArray's element type.");
+  }
+  if (sharding_.isReplicated()) {
+    return std::async(std::launch::deferred, [copy = shards_.front().template toHost<T>()]() mutable { return copy.get(); });
+  }
+
+  const SplitLayout layout = splitLayout(shape_, sharding_, shards_.size());
+  std::vector<T> result(layout.outer * layout.globalBlock);
+  std::vector<std::future<void>> copies;
+  copies.reserve(shards_.size());
+  if (layout.outer == 1) {
+    // Split along the outermost non-trivial axis: every shard is one contiguous range of the result, so copy straight into it.
+    for (size_t i = 0; i < shards_.size(); ++i) {
+      copies.push_back(shards_[i].toHost(result.data() + i * layout.shardBlock, layout.shardBlock));
+    }
+    return std::async(std::launch::deferred, [result = std::move(result), copies = std::move(copies)]() mutable {
+      for (std::future<void> &copy : copies) {
+        copy.get();
+      }
+      return std::move(result);
+    });
+  }
+
+  // Otherwise the shards interleave in the result. Read each one whole, then put its blocks in place.
+  std::vector<std::vector<T>> staging(shards_.size(), std::vector<T>(layout.outer * layout.shardBlock));
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    copies.push_back(shards_[i].toHost(staging[i].data(), staging[i].size()));
+  }
+  return std::async(std::launch::deferred, [layout, result = std::move(result), staging = std::move(staging), copies = std::move(copies)]() mutable {
+    for (size_t i = 0; i < copies.size(); ++i) {
+      copies[i].get();
+      for (size_t o = 0; o < layout.outer; ++o) {
+        std::copy_n(staging[i].data() + o * layout.shardBlock, layout.shardBlock, result.data() + o * layout.globalBlock + i * layout.shardBlock);
+      }
+    }
+    return std::move(result);
+  });
+}
+
+} // namespace pjrt
+
+#endif // PJRT_SHARDED_ARRAY_HPP_
@@ -0,0 +1,18 @@
+#include "sharedBuffer.hpp"
+#include "deviceView.hpp"
+#include "memoryView.hpp"
+
+#include <utility>
+
+namespace pjrt {
+
+SharedBuffer::SharedBuffer(Buffer &&buffer) : buffer_(std::make_shared<const Buffer>(std::move(buffer))) {
+  buffer_->elementType();
+  buffer_->device();
+  buffer_->memory();
+  buffer_->memoryLayout();
+  buffer_->onDeviceSizeInBytes();
+  buffer_->hostSizeInBytes();
+}
+
+} // namespace pjrt
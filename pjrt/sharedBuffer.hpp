@@ -0,0 +1,31 @@
+#ifndef PJRT_SHARED_BUFFER_HPP_
+#define PJRT_SHARED_BUFFER_HPP_
+
+#include "pjrt/buffer.hpp"
+
+#include <memory>
+
+namespace pjrt {
+
+// A Buffer with shared ownership, e.g. model weights read by several request handlers at once.
+// Copies share one PJRT_Buffer through an atomic reference count, so they may be created, passed between threads and destroyed
+// concurrently. The PJRT_Buffer is destroyed once the last copy is gone and every execution launched with it has completed.
+// Shared buffers are read-only: they are never donated to an execution and give out only const access.
+class SharedBuffer {
+public:
+  // Takes ownership of `buffer`. Every cached property of the Buffer is filled here, so that concurrent users only ever read the cache.
+  explicit SharedBuffer(Buffer &&buffer);
+
+  const Buffer& operator*() const { return *buffer_; }
+  const Buffer* operator->() const { return buffer_.get(); }
+  const Buffer& get() const { return *buffer_; }
+
+  // Number of SharedBuffer copies and in-flight executions currently holding the buffer.
+  long useCount() const { return buffer_.use_count(); }
+// private:
+  std::shared_ptr<const Buffer> buffer_;
+};
+
+} // namespace pjrt
+
+#endif // PJRT_SHARED_BUFFER_HPP_
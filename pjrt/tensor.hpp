@@ -0,0 +1,75 @@
+#ifndef PJRT_TENSOR_HPP_
+#define PJRT_TENSOR_HPP_
+
+#include "pjrt/buffer.hpp"
+#include "pjrt/detail/types.hpp"
+#include "pjrt/exception.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pjrt {
+
+// A Buffer whose element type is known to be T.
+// The element type and host size are checked against PJRT once, on construction. Afterwards reads never query the buffer's
+// size and never reinterpret its data as the wrong type, which makes Tensor the preferred handle for buffers read every step.
+template <typename T>
+class Tensor {
+public:
+  // Takes ownership of `buffer`. Throws if its element type is not T, or if its host representation is not a dense array of T.
+  explicit Tensor(Buffer &&buffer);
+
+  const Shape& dimensions() const { return buffer_.dimensions(); }
+  size_t numElements() const { return numElements_; }
+
+  Buffer& buffer() { return buffer_; }
+  const Buffer& buffer() const { return buffer_; }
+  // Gives up ownership of the underlying Buffer, e.g. to pass it back to a BufferPool. This Tensor is left empty.
+  Buffer releaseBuffer() { return std::move(buffer_); }
+
+  // Asynchronously copies the whole tensor to the host.
+  std::future<std::vector<T>> toHost() const { return buffer_.template toHost<T>(); }
+
+  // Asynchronously copies the whole tensor into `data`, which must have room for numElements() elements and must stay alive until the future is ready.
+  std::future<void> toHost(T *data) const { return buffer_.toHost(data, numElements_); }
+
+  // Reads the tensor in place where possible, see Buffer::hostView().
+  HostView<T> hostView() const { return buffer_.template hostView<T>(); }
+
+  // Asynchronously reads a tensor which holds a single element. Throws if it holds more.
+  std::future<T> toHostScalar() const;
+// private:
+  Buffer buffer_;
+  size_t numElements_{1};
+};
+
+template <typename T>
+Tensor<T>::Tensor(Buffer &&buffer) : buffer_(std::move(buffer)) {
+  constexpr PJRT_Buffer_Type kType = detail::TypeToPjrtBufferType<T>();
+  if (buffer_.elementType() != kType) {
+    throw pjrt::Exception("Tensor expects element type " + std::to_string(kType) + ", but the buffer has element type " + std::to_string(buffer_.elementType()) + ".");
+  }
+  for (int64_t dim : buffer_.dimensions()) {
+    numElements_ *= static_cast<size_t>(dim);
+  }
+  // Also fills the buffer's cached host size, which toHost() relies on.
+  if (buffer_.hostSizeInBytes() != numElements_ * sizeof(T)) {
+    throw pjrt::Exception("Tensor expects " + std::to_string(numElements_ * sizeof(T)) + " bytes on the host, but the buffer needs " + std::to_string(buffer_.hostSizeInBytes()) + ".");
+  }
+}
+
+template <typename T>
+std::future<T> Tensor<T>::toHostScalar() const {
+  if (numElements_ != 1) {
+    throw pjrt::Exception("toHostScalar() called on a tensor with " + std::to_string(numElements_) + " elements.");
+  }
+  return buffer_.template toHostScalar<T>();
+}
+
+} // namespace pjrt
+
+#endif // PJRT_TENSOR_HPP_
@@ -0,0 +1,151 @@
+#include "pjrt/admissionController.hpp"
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/loadedExecutable.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kAddProgram = R"delim(
+module @jit_add attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> (tensor<4xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg1 : tensor<4xf32>
+    return %0 : tensor<4xf32>
+  }
+})delim";
+
+class AdmissionControllerTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+
+    // Options which leave `bytes` for admitted launches on top of whatever the device already uses.
+    pjrt::AdmissionController::Options optionsWithRoomFor(int64_t bytes) {
+        int64_t inUse = 0;
+        try {
+            inUse = device_->memoryStats().bytesInUse;
+        } catch (const pjrt::Exception &) {
+        }
+        pjrt::AdmissionController::Options options;
+        options.capacityBytes = inUse + bytes;
+        options.pollInterval = std::chrono::milliseconds(1);
+        return options;
+    }
+
+    // Polls `condition` for up to a second.
+    template <typename Condition>
+    static bool eventually(Condition condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+};
+
+TEST_F(AdmissionControllerTest, AdmitsWhatFits) {
+    pjrt::AdmissionController controller(*device_, optionsWithRoomFor(1000));
+    pjrt::AdmissionController::Admission first = controller.admit(400);
+    pjrt::AdmissionController::Admission second = controller.admit(400);
+    EXPECT_EQ(controller.stats().reservedBytes, 800);
+    EXPECT_EQ(controller.stats().admitted, 2);
+    EXPECT_EQ(controller.stats().queued, 0);
+
+    first.release();
+    EXPECT_EQ(controller.stats().reservedBytes, 400);
+}
+
+TEST_F(AdmissionControllerTest, RejectsWhatCanNeverFit) {
+    pjrt::AdmissionController controller(*device_, optionsWithRoomFor(1000));
+    EXPECT_THROW(controller.admit(1'000'000'000'000), pjrt::Exception);
+}
+
+TEST_F(AdmissionControllerTest, QueuesUntilMemoryIsReleased) {
+    pjrt::AdmissionController controller(*device_, optionsWithRoomFor(1000));
+    pjrt::AdmissionController::Admission held = controller.admit(800);
+
+    std::thread waiter([&]() {
+        pjrt::AdmissionController::Admission admission = controller.admit(500);
+    });
+    ASSERT_TRUE(eventually([&]() { return controller.stats().queueLength == 1; }));
+    EXPECT_EQ(controller.stats().admitted, 1);
+
+    held.release();
+    waiter.join();
+    EXPECT_EQ(controller.stats().admitted, 2);
+    EXPECT_EQ(controller.stats().queued, 1);
+    EXPECT_EQ(controller.stats().reservedBytes, 0);
+}
+
+TEST_F(AdmissionControllerTest, AdmitsInArrivalOrder) {
+    pjrt::AdmissionController controller(*device_, optionsWithRoomFor(1000));
+    pjrt::AdmissionController::Admission held = controller.admit(900);
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    std::thread large([&]() {
+        pjrt::AdmissionController::Admission admission = controller.admit(500);
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(1);
+    });
+    ASSERT_TRUE(eventually([&]() { return controller.stats().queueLength == 1; }));
+    // Would fit right away, but must not overtake the large launch.
+    std::thread small([&]() {
+        pjrt::AdmissionController::Admission admission = controller.admit(50);
+        std::lock_guard<std::mutex> lock(orderMutex);
+        order.push_back(2);
+    });
+    ASSERT_TRUE(eventually([&]() { return controller.stats().queueLength == 2; }));
+
+    held.release();
+    large.join();
+    small.join();
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+}
+
+TEST_F(AdmissionControllerTest, ExecuteHoldsReservationUntilCompletion) {
+    pjrt::LoadedExecutable executable = client_.compileFromStableHloString(kAddProgram);
+    if (!executable.compiledMemoryStats()) {
+        GTEST_SKIP() << "The PJRT plugin does not report compiled memory statistics.";
+    }
+    // The launches below do not donate, so aliased outputs cannot reuse argument memory.
+    const int64_t footprint = pjrt::AdmissionController::footprint(executable, /*allowDonation=*/false);
+    EXPECT_GE(footprint, static_cast<int64_t>(4 * sizeof(float)));
+    EXPECT_GE(footprint, pjrt::AdmissionController::footprint(executable, /*allowDonation=*/true));
+
+    pjrt::AdmissionController controller(*device_, optionsWithRoomFor(footprint));
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer lhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    pjrt::Buffer rhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    std::vector<pjrt::Buffer*> arguments = {&lhs, &rhs};
+
+    // The second launch has to wait for the first one to complete.
+    for (int i = 0; i < 2; ++i) {
+        std::vector<pjrt::Buffer> outputs = controller.execute(executable, arguments, /*allowDonation=*/false).get();
+        EXPECT_EQ(outputs[0].toHost<float>().get(), (std::vector<float>{2.0f, 4.0f, 6.0f, 8.0f}));
+    }
+    EXPECT_EQ(controller.stats().admitted, 2);
+    EXPECT_TRUE(eventually([&]() { return controller.stats().reservedBytes == 0; }));
+}
+
+} // namespace
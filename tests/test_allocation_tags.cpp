@@ -0,0 +1,193 @@
+#include "pjrt/allocationTags.hpp"
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/loadedExecutable.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kAddProgram = R"delim(
+module @jit_add attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> (tensor<4xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg1 : tensor<4xf32>
+    return %0 : tensor<4xf32>
+  }
+})delim";
+
+// Adds its arguments, reusing the first argument's storage for the result so that PJRT donates it.
+const std::string kDonatingAddProgram = R"delim(
+module @jit_add attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<4xf32> {tf.aliasing_output = 0 : i32}, %arg1: tensor<4xf32>) -> (tensor<4xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg1 : tensor<4xf32>
+    return %0 : tensor<4xf32>
+  }
+})delim";
+
+// Returns the usage of `tag` in `usage`, or an empty entry if it is not there.
+pjrt::AllocationTagUsage usageOf(const std::vector<pjrt::AllocationTagUsage> &usage, const std::string &tag) {
+    for (const pjrt::AllocationTagUsage &entry : usage) {
+        if (entry.tag == tag) {
+            return entry;
+        }
+    }
+    return pjrt::AllocationTagUsage();
+}
+
+TEST(AllocationTagRegistryTest, InternsTagsByName) {
+    pjrt::AllocationTagRegistry registry;
+    const pjrt::AllocationTag first = registry.tag("model");
+    const pjrt::AllocationTag second = registry.tag("model");
+    const pjrt::AllocationTag other = registry.tag("cache");
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(first.name(), "model");
+    EXPECT_FALSE(pjrt::AllocationTag());
+
+    // Ordered by name.
+    const std::vector<pjrt::AllocationTagUsage> usage = registry.snapshot();
+    ASSERT_EQ(usage.size(), 2);
+    EXPECT_EQ(usage[0].tag, "cache");
+    EXPECT_EQ(usage[1].tag, "model");
+}
+
+TEST(AllocationTagRegistryTest, TagsKnowTheirRegistry) {
+    pjrt::AllocationTagRegistry registry;
+    pjrt::AllocationTagRegistry otherRegistry;
+    const pjrt::AllocationTag tag = registry.tag("model");
+    EXPECT_TRUE(tag.belongsTo(registry));
+    // Same name, different Context.
+    EXPECT_FALSE(tag.belongsTo(otherRegistry));
+    EXPECT_NE(tag, otherRegistry.tag("model"));
+    EXPECT_TRUE(pjrt::AllocationTag().belongsTo(otherRegistry));
+}
+
+TEST(AllocationTagRegistryTest, CountsLiveAndPeakBytes) {
+    pjrt::AllocationTagRegistry registry;
+    const pjrt::AllocationTag tag = registry.tag("model");
+    tag.counters_->charge(100);
+    tag.counters_->charge(50);
+    tag.counters_->refund(100);
+
+    const pjrt::AllocationTagUsage usage = usageOf(registry.snapshot(), "model");
+    EXPECT_EQ(usage.liveBytes, 50);
+    EXPECT_EQ(usage.liveBuffers, 1);
+    EXPECT_EQ(usage.peakBytes, 150);
+    EXPECT_EQ(usage.totalBuffers, 2);
+}
+
+TEST(AllocationTagScopeTest, InnermostScopeWins) {
+    pjrt::AllocationTagRegistry registry;
+    const pjrt::AllocationTag outer = registry.tag("outer");
+    const pjrt::AllocationTag inner = registry.tag("inner");
+    EXPECT_FALSE(pjrt::AllocationTagScope::current());
+    {
+        pjrt::AllocationTagScope outerScope(outer);
+        EXPECT_EQ(pjrt::AllocationTagScope::current(), outer);
+        {
+            pjrt::AllocationTagScope innerScope(inner);
+            EXPECT_EQ(pjrt::AllocationTagScope::current(), inner);
+        }
+        EXPECT_EQ(pjrt::AllocationTagScope::current(), outer);
+    }
+    EXPECT_FALSE(pjrt::AllocationTagScope::current());
+}
+
+class AllocationTagTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(AllocationTagTest, ScopeTagsUploadsAndAllocations) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    std::optional<pjrt::Buffer> uploaded;
+    std::optional<pjrt::Buffer> allocated;
+    {
+        pjrt::AllocationTagScope scope(context_.allocationTag("weights"));
+        uploaded.emplace(client_.transferToDevice(input.data(), {4}, *device_).get());
+        allocated.emplace(client_.allocate<float>({8}, *device_));
+    }
+    pjrt::Buffer untagged = client_.transferToDevice(input.data(), {4}, *device_).get();
+    EXPECT_EQ(uploaded->allocationTag().name(), "weights");
+    EXPECT_FALSE(untagged.allocationTag());
+
+    pjrt::AllocationTagUsage usage = usageOf(context_.allocationTagUsage(), "weights");
+    EXPECT_EQ(usage.liveBuffers, 2);
+    EXPECT_EQ(usage.liveBytes, static_cast<int64_t>(uploaded->onDeviceSizeInBytes() + allocated->onDeviceSizeInBytes()));
+
+    uploaded.reset();
+    allocated->destroy();
+    usage = usageOf(context_.allocationTagUsage(), "weights");
+    EXPECT_EQ(usage.liveBuffers, 0);
+    EXPECT_EQ(usage.liveBytes, 0);
+    EXPECT_GT(usage.peakBytes, 0);
+}
+
+TEST_F(AllocationTagTest, ScopeTagsExecutionOutputs) {
+    pjrt::LoadedExecutable executable = client_.compileFromStableHloString(kAddProgram);
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer lhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    pjrt::Buffer rhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    std::vector<pjrt::Buffer*> arguments = {&lhs, &rhs};
+
+    std::vector<pjrt::Buffer> outputs;
+    {
+        pjrt::AllocationTagScope scope(context_.allocationTag("activations"));
+        outputs = executable.execute(*device_, arguments, /*allowDonation=*/false).get();
+    }
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs[0].allocationTag().name(), "activations");
+    EXPECT_EQ(usageOf(context_.allocationTagUsage(), "activations").liveBuffers, 1);
+}
+
+TEST_F(AllocationTagTest, DonationEndsTheAttribution) {
+    pjrt::LoadedExecutable executable = client_.compileFromStableHloString(kDonatingAddProgram);
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer lhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    pjrt::Buffer rhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    lhs.setAllocationTag(context_.allocationTag("weights"));
+
+    std::vector<pjrt::Buffer*> arguments = {&lhs, &rhs};
+    std::vector<pjrt::Buffer> outputs = executable.execute(*device_, arguments).get();
+    if (!lhs.isDeleted()) {
+        GTEST_SKIP() << "The PJRT plugin did not donate the argument.";
+    }
+    // The wrapper is still alive, but its memory now belongs to the output.
+    EXPECT_FALSE(lhs.allocationTag());
+    const pjrt::AllocationTagUsage usage = usageOf(context_.allocationTagUsage(), "weights");
+    EXPECT_EQ(usage.liveBuffers, 0);
+    EXPECT_EQ(usage.liveBytes, 0);
+}
+
+TEST_F(AllocationTagTest, RetaggingMovesTheBytes) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+    buffer.setAllocationTag(context_.allocationTag("staging"));
+    buffer.setAllocationTag(context_.allocationTag("weights"));
+
+    const std::vector<pjrt::AllocationTagUsage> usage = context_.allocationTagUsage();
+    EXPECT_EQ(usageOf(usage, "staging").liveBytes, 0);
+    EXPECT_EQ(usageOf(usage, "weights").liveBytes, static_cast<int64_t>(buffer.onDeviceSizeInBytes()));
+
+    // The attribution follows the PJRT_Buffer, not the Buffer object.
+    pjrt::Buffer moved(std::move(buffer));
+    EXPECT_FALSE(buffer.allocationTag());
+    EXPECT_EQ(moved.allocationTag().name(), "weights");
+    EXPECT_EQ(usageOf(context_.allocationTagUsage(), "weights").liveBuffers, 1);
+}
+
+} // namespace
@@ -0,0 +1,71 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/memoryView.hpp"
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class BufferCopyTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(BufferCopyTest, DeviceHasAddressableMemories) {
+    std::vector<pjrt::MemoryView> memories;
+    ASSERT_NO_THROW(memories = device_->addressableMemories());
+    ASSERT_FALSE(memories.empty());
+
+    const pjrt::MemoryView defaultMemory = device_->defaultMemory();
+    std::cout << "  [INFO] Default memory kind: \"" << defaultMemory.kind() << "\"" << std::endl;
+    EXPECT_FALSE(client_.getAddressableMemories().empty());
+}
+
+TEST_F(BufferCopyTest, CopyToOtherMemoryRoundTrip) {
+    const std::string defaultKind = device_->defaultMemory().kind();
+    std::optional<pjrt::MemoryView> otherMemory;
+    for (pjrt::MemoryView &memory : device_->addressableMemories()) {
+        if (memory.kind() != defaultKind) {
+            otherMemory.emplace(std::move(memory));
+            break;
+        }
+    }
+    if (!otherMemory) {
+        GTEST_SKIP() << "Device has only one kind of memory.";
+    }
+
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+    pjrt::Buffer otherBuffer = buffer.copyToMemory(*otherMemory);
+    pjrt::Buffer backOnDevice = otherBuffer.copyToMemory(device_->defaultMemory());
+
+    EXPECT_EQ(otherBuffer.dimensions(), buffer.dimensions());
+    EXPECT_EQ(backOnDevice.toHost<float>().get(), input);
+}
+
+TEST_F(BufferCopyTest, CopyToOtherDevice) {
+    if (client_.getNumDevices() < 2) {
+        GTEST_SKIP() << "Need at least two devices.";
+    }
+    const pjrt::DeviceView otherDevice = client_.getDevice(/*deviceNumber=*/1);
+
+    const std::vector<int32_t> input = {7, 8, 9};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {3}, *device_).get();
+    pjrt::Buffer copy = buffer.copyToDevice(otherDevice);
+    EXPECT_EQ(copy.toHost<int32_t>().get(), input);
+}
+
+} // namespace
@@ -0,0 +1,79 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/bufferPool.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/rawBuffer.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class BufferPoolTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(BufferPoolTest, RecyclesReleasedBuffers) {
+    pjrt::BufferPool pool(client_);
+    pjrt::Buffer first = pool.acquire<float>({8, 4}, *device_);
+    PJRT_Buffer *firstHandle = first.c_buffer();
+    EXPECT_EQ(pool.stats().misses, 1);
+
+    pool.release(std::move(first));
+    EXPECT_EQ(pool.stats().residentBuffers, 1);
+    EXPECT_EQ(pool.stats().residentBytes, 8 * 4 * sizeof(float));
+
+    // A different shape or type does not match.
+    pjrt::Buffer other = pool.acquire<int32_t>({8, 4}, *device_);
+    EXPECT_EQ(pool.stats().misses, 2);
+
+    pjrt::Buffer second = pool.acquire<float>({8, 4}, *device_);
+    EXPECT_EQ(second.c_buffer(), firstHandle);
+    EXPECT_EQ(pool.stats().hits, 1);
+    EXPECT_EQ(pool.stats().residentBytes, 0);
+}
+
+TEST_F(BufferPoolTest, UploadRoundTrip) {
+    pjrt::BufferPool pool(client_);
+    for (int step = 0; step < 3; ++step) {
+        const std::vector<int32_t> labels = {step, step + 1, step + 2};
+        pjrt::Buffer buffer = pool.upload(labels.data(), {3}, *device_);
+        EXPECT_EQ(buffer.toHost<int32_t>().get(), labels);
+        pool.release(std::move(buffer));
+    }
+    // Either each upload reuses the released buffer, or it frees the released buffer and transfers into a new one.
+    EXPECT_EQ(pool.stats().residentBuffers, 1);
+    if (pjrt::RawBuffer::isSupported(context_)) {
+        EXPECT_EQ(pool.stats().inPlaceUploads, 3);
+        EXPECT_EQ(pool.stats().hits, 2);
+    } else {
+        EXPECT_EQ(pool.stats().inPlaceUploads, 0);
+        EXPECT_EQ(pool.stats().evictions, 2);
+    }
+}
+
+TEST_F(BufferPoolTest, EvictsOverBudget) {
+    pjrt::BufferPool pool(client_, /*maxResidentBytes=*/16);
+    pjrt::Buffer first = pool.acquire<float>({4}, *device_);
+    pjrt::Buffer second = pool.acquire<float>({4}, *device_);
+    pool.release(std::move(first));
+    pool.release(std::move(second));
+    EXPECT_EQ(pool.stats().residentBuffers, 1);
+    EXPECT_EQ(pool.stats().evictions, 1);
+
+    pool.clear();
+    EXPECT_EQ(pool.stats().residentBytes, 0);
+}
+
+} // namespace
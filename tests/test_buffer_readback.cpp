@@ -0,0 +1,84 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/hostArena.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Test fixture for PJRT context and client
+class BufferReadbackTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(BufferReadbackTest, ToHostIntoCallerProvidedMemory) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2, 3}, *device_).get();
+
+    std::array<float, 6> output{};
+    ASSERT_NO_THROW(buffer.toHost(output.data(), output.size()).get());
+    EXPECT_EQ(std::vector<float>(output.begin(), output.end()), input);
+}
+
+TEST_F(BufferReadbackTest, ToHostScalar) {
+    const float input = 3.5f;
+    pjrt::Buffer buffer = client_.transferToDevice(&input, {}, *device_).get();
+
+    float output = 0.0f;
+    ASSERT_NO_THROW(output = buffer.toHostScalar<float>().get());
+    EXPECT_EQ(output, input);
+}
+
+TEST_F(BufferReadbackTest, CopyRawToHostRange) {
+    const std::vector<int32_t> input = {10, 11, 12, 13, 14, 15, 16, 17};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {8}, *device_).get();
+
+    // Read elements [2, 6).
+    std::array<int32_t, 4> output{};
+    ASSERT_NO_THROW(buffer.copyRawToHost(output.data(), 2 * sizeof(int32_t), output.size() * sizeof(int32_t)).get());
+    EXPECT_EQ(output, (std::array<int32_t, 4>{12, 13, 14, 15}));
+}
+
+TEST_F(BufferReadbackTest, ToHostWithTransposingLayout) {
+    // Row-major 2x3.
+    const std::vector<float> input = {0.0f, 1.0f, 2.0f,
+                                      3.0f, 4.0f, 5.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2, 3}, *device_).get();
+
+    // Ask for column-major data on the host.
+    const pjrt::MemoryLayout columnMajor = pjrt::MemoryLayout::majorToMinor({1, 0});
+    std::vector<float> output;
+    ASSERT_NO_THROW(output = buffer.toHost<float>(columnMajor).get());
+    EXPECT_EQ(output, (std::vector<float>{0.0f, 3.0f, 1.0f, 4.0f, 2.0f, 5.0f}));
+}
+
+TEST_F(BufferReadbackTest, ReadbackAllIntoOneArena) {
+    const float loss = 0.25f;
+    const std::vector<int32_t> counts = {1, 2, 3};
+    const std::vector<double> metrics = {0.5, 1.5};
+    pjrt::Buffer lossBuffer = client_.transferToDevice(&loss, {}, *device_).get();
+    pjrt::Buffer countsBuffer = client_.transferToDevice(counts.data(), {3}, *device_).get();
+    pjrt::Buffer metricsBuffer = client_.transferToDevice(metrics.data(), {2}, *device_).get();
+
+    pjrt::HostArena arena = pjrt::readbackAll({&lossBuffer, &countsBuffer, &metricsBuffer}).get();
+    ASSERT_EQ(arena.size(), 3);
+    EXPECT_EQ(*arena.data<float>(0), loss);
+    EXPECT_EQ(std::vector<int32_t>(arena.data<int32_t>(1), arena.data<int32_t>(1) + arena.count<int32_t>(1)), counts);
+    EXPECT_EQ(std::vector<double>(arena.data<double>(2), arena.data<double>(2) + arena.count<double>(2)), metrics);
+}
+
+} // namespace
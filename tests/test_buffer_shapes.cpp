@@ -78,6 +78,16 @@ module @jit_my_function attributes {mhlo.num_partitions = 1 : i32, mhlo.num_repl
         << "Output shape mismatch.";
 }
 
+TEST_F(BufferShapeTest, AllocateUninitializedShape) {
+    const std::vector<int64_t> shape = {4, 5};
+    std::optional<pjrt::Buffer> buffer;
+    ASSERT_NO_THROW(buffer.emplace(client_.allocate<float>(shape, *device_)));
+    EXPECT_EQ(buffer->dimensions(), shape);
+
+    // Nothing was uploaded, but the buffer still has the full size.
+    EXPECT_EQ(buffer->toHost<float>().get().size(), 4u * 5u);
+}
+
 // TODO: Add TEST_F(BufferShapeTest, ExecuteVectorOutputShape) if feasible
 
 } // namespace
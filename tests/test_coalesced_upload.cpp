@@ -0,0 +1,75 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/coalescedUploader.hpp"
+#include "pjrt/context.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class CoalescedUploadTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(CoalescedUploadTest, SplitsMixedTensors) {
+    const std::vector<uint8_t> tokens = {1, 2, 3, 4, 5};
+    const std::vector<float> features = {0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f};
+    const int32_t length = 5;
+    const std::vector<double> weights = {0.25, 0.75};
+
+    pjrt::CoalescedUploader uploader(client_, *device_);
+    uploader.add(tokens.data(), {5});
+    uploader.add(features.data(), {2, 3});
+    uploader.add(&length, {});
+    uploader.add(weights.data(), {2});
+
+    std::vector<pjrt::Buffer> buffers;
+    ASSERT_NO_THROW(buffers = uploader.upload().get());
+    ASSERT_EQ(buffers.size(), 4);
+    EXPECT_EQ(buffers[1].dimensions(), (std::vector<int64_t>{2, 3}));
+    EXPECT_EQ(buffers[0].toHost<uint8_t>().get(), tokens);
+    EXPECT_EQ(buffers[1].toHost<float>().get(), features);
+    EXPECT_EQ(buffers[2].toHostScalar<int32_t>().get(), length);
+    EXPECT_EQ(buffers[3].toHost<double>().get(), weights);
+
+    const pjrt::CoalescedUploader::BatchStats &stats = uploader.lastBatchStats();
+    EXPECT_EQ(stats.tensors, 4);
+    EXPECT_EQ(stats.transfersSaved, 3);
+    EXPECT_FALSE(stats.programCacheHit);
+    EXPECT_EQ(uploader.size(), 0);
+}
+
+TEST_F(CoalescedUploadTest, ReusesProgramForSameSignature) {
+    pjrt::CoalescedUploader uploader(client_, *device_);
+    for (int32_t batch = 0; batch < 3; ++batch) {
+        const std::vector<int32_t> ids = {batch, batch + 1};
+        const float scale = static_cast<float>(batch);
+        uploader.add(ids.data(), {2});
+        uploader.add(&scale, {});
+        std::vector<pjrt::Buffer> buffers = uploader.upload().get();
+        EXPECT_EQ(buffers[0].toHost<int32_t>().get(), ids);
+        EXPECT_EQ(buffers[1].toHostScalar<float>().get(), scale);
+        EXPECT_EQ(uploader.lastBatchStats().programCacheHit, batch > 0);
+    }
+    EXPECT_EQ(uploader.numCachedPrograms(), 1);
+}
+
+TEST_F(CoalescedUploadTest, EmptyBatch) {
+    pjrt::CoalescedUploader uploader(client_, *device_);
+    EXPECT_TRUE(uploader.upload().get().empty());
+    EXPECT_EQ(uploader.lastBatchStats().transfersSaved, 0);
+}
+
+} // namespace
@@ -0,0 +1,154 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/compilationCache.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/detail/hash.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/loadedExecutable.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kAddProgram = R"delim(
+module @jit_add attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> (tensor<4xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg1 : tensor<4xf32>
+    return %0 : tensor<4xf32>
+  }
+})delim";
+
+const std::string kMultiplyProgram = R"delim(
+module @jit_multiply attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> (tensor<4xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.multiply %arg0, %arg1 : tensor<4xf32>
+    return %0 : tensor<4xf32>
+  }
+})delim";
+
+// Cache entries are named by this hash, so it must keep producing the published FNV-1a values.
+TEST(PersistentHashTest, MatchesFnv1aReferenceValues) {
+    const std::string a = "a";
+    const std::string foobar = "foobar";
+    EXPECT_EQ(pjrt::detail::fnv1aHash(nullptr, 0), 0xcbf29ce484222325ULL);
+    EXPECT_EQ(pjrt::detail::fnv1aHash(a.data(), a.size()), 0xaf63dc4c8601ec8cULL);
+    EXPECT_EQ(pjrt::detail::fnv1aHash(foobar.data(), foobar.size()), 0x85944171f73967e8ULL);
+    // Hashing in pieces continues where the previous piece ended.
+    EXPECT_EQ(pjrt::detail::fnv1aHash(foobar.data() + 3, 3, pjrt::detail::fnv1aHash(foobar.data(), 3)), 0x85944171f73967e8ULL);
+}
+
+class CompilationCacheTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+    std::filesystem::path directory_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+        directory_ = std::filesystem::temp_directory_path() / ("pjrt_compilation_cache_test_" + std::to_string(std::random_device{}()));
+    }
+
+    void TearDown() override {
+        std::error_code error;
+        std::filesystem::remove_all(directory_, error);
+    }
+
+    std::vector<std::filesystem::path> entries() const {
+        std::vector<std::filesystem::path> paths;
+        for (const auto &entry : std::filesystem::directory_iterator(directory_)) {
+            paths.push_back(entry.path());
+        }
+        return paths;
+    }
+
+    std::vector<float> run(pjrt::LoadedExecutable &executable) {
+        const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+        pjrt::Buffer lhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+        pjrt::Buffer rhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+        std::vector<pjrt::Buffer*> arguments = {&lhs, &rhs};
+        std::vector<pjrt::Buffer> outputs = executable.execute(*device_, arguments, /*allowDonation=*/false).get();
+        return outputs[0].toHost<float>().get();
+    }
+};
+
+TEST_F(CompilationCacheTest, LoadsWhatAnEarlierCacheCompiled) {
+    {
+        pjrt::CompilationCache cache(client_, directory_);
+        pjrt::LoadedExecutable executable = cache.compileFromStableHloString(kAddProgram);
+        if (cache.stats().writeFailures > 0) {
+            GTEST_SKIP() << "The PJRT plugin does not serialize executables.";
+        }
+        EXPECT_EQ(cache.stats().misses, 1);
+        EXPECT_EQ(cache.stats().writes, 1);
+        EXPECT_EQ(entries().size(), 1);
+    }
+
+    // As after a restart.
+    pjrt::CompilationCache cache(client_, directory_);
+    pjrt::LoadedExecutable executable = cache.compileFromStableHloString(kAddProgram);
+    EXPECT_EQ(cache.stats().hits, 1);
+    EXPECT_EQ(cache.stats().misses, 0);
+    EXPECT_EQ(run(executable), (std::vector<float>{2.0f, 4.0f, 6.0f, 8.0f}));
+}
+
+TEST_F(CompilationCacheTest, DistinguishesPrograms) {
+    pjrt::CompilationCache cache(client_, directory_);
+    pjrt::LoadedExecutable add = cache.compileFromStableHloString(kAddProgram);
+    pjrt::LoadedExecutable multiply = cache.compileFromStableHloString(kMultiplyProgram);
+    if (cache.stats().writeFailures > 0) {
+        GTEST_SKIP() << "The PJRT plugin does not serialize executables.";
+    }
+    EXPECT_EQ(cache.stats().misses, 2);
+    EXPECT_EQ(entries().size(), 2);
+
+    pjrt::LoadedExecutable cachedMultiply = cache.compileFromStableHloString(kMultiplyProgram);
+    EXPECT_EQ(cache.stats().hits, 1);
+    EXPECT_EQ(run(cachedMultiply), (std::vector<float>{1.0f, 4.0f, 9.0f, 16.0f}));
+}
+
+TEST_F(CompilationCacheTest, RecompilesCorruptEntries) {
+    pjrt::CompilationCache cache(client_, directory_);
+    pjrt::LoadedExecutable executable = cache.compileFromStableHloString(kAddProgram);
+    if (cache.stats().writeFailures > 0) {
+        GTEST_SKIP() << "The PJRT plugin does not serialize executables.";
+    }
+    ASSERT_EQ(entries().size(), 1);
+    {
+        std::ofstream truncated(entries()[0], std::ios::binary | std::ios::trunc);
+        truncated << "PJRTEXE2";
+    }
+
+    pjrt::LoadedExecutable recompiled = cache.compileFromStableHloString(kAddProgram);
+    EXPECT_EQ(cache.stats().loadFailures, 1);
+    EXPECT_EQ(cache.stats().misses, 2);
+    EXPECT_EQ(run(recompiled), (std::vector<float>{2.0f, 4.0f, 6.0f, 8.0f}));
+    EXPECT_EQ(entries().size(), 1);
+}
+
+TEST_F(CompilationCacheTest, EvictsLeastRecentlyUsedEntries) {
+    pjrt::CompilationCache::Options options;
+    options.maxBytes = 1;
+    pjrt::CompilationCache cache(client_, directory_, options);
+    pjrt::LoadedExecutable add = cache.compileFromStableHloString(kAddProgram);
+    pjrt::LoadedExecutable multiply = cache.compileFromStableHloString(kMultiplyProgram);
+    if (cache.stats().writeFailures > 0) {
+        GTEST_SKIP() << "The PJRT plugin does not serialize executables.";
+    }
+    // The entry just written is kept even though it alone exceeds the budget.
+    EXPECT_EQ(cache.stats().evictions, 1);
+    EXPECT_EQ(entries().size(), 1);
+
+    pjrt::LoadedExecutable cachedMultiply = cache.compileFromStableHloString(kMultiplyProgram);
+    EXPECT_EQ(cache.stats().hits, 1);
+}
+
+} // namespace
@@ -0,0 +1,95 @@
+#include "pjrt/client.hpp"
+#include "pjrt/constantCache.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/detail/hash.hpp"
+#include "pjrt/sharedBuffer.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(HashBytesTest, DependsOnEveryByteAndTheLength) {
+    std::vector<uint8_t> bytes(100, 0);
+    const uint64_t base = pjrt::detail::hashBytes(bytes.data(), bytes.size());
+    EXPECT_EQ(pjrt::detail::hashBytes(bytes.data(), bytes.size()), base);
+    for (size_t i : {size_t{0}, size_t{31}, size_t{64}, size_t{99}}) {
+        bytes[i] = 1;
+        EXPECT_NE(pjrt::detail::hashBytes(bytes.data(), bytes.size()), base) << "byte " << i;
+        bytes[i] = 0;
+    }
+    EXPECT_NE(pjrt::detail::hashBytes(bytes.data(), bytes.size() - 1), base);
+    EXPECT_NE(pjrt::detail::hashBytes(bytes.data(), bytes.size(), /*seed=*/1), base);
+}
+
+class ConstantCacheTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(ConstantCacheTest, SameContentIsUploadedOnce) {
+    pjrt::ConstantCache cache(client_);
+    const std::vector<float> table = {1.0f, 2.0f, 3.0f, 4.0f};
+    const std::vector<float> copyOfTable = table;
+
+    pjrt::SharedBuffer first = cache.get(table.data(), {4}, *device_);
+    pjrt::SharedBuffer second = cache.get(copyOfTable.data(), {4}, *device_);
+    EXPECT_EQ(first->c_buffer(), second->c_buffer());
+    EXPECT_EQ(second->toHost<float>().get(), table);
+
+    const pjrt::ConstantCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.bytesSaved, table.size() * sizeof(float));
+    EXPECT_EQ(stats.residentEntries, 1);
+}
+
+TEST_F(ConstantCacheTest, ShapeAndTypeArePartOfTheKey) {
+    pjrt::ConstantCache cache(client_);
+    const std::vector<int32_t> values = {0, 0, 0, 0};
+    const std::vector<float> zeros = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    pjrt::SharedBuffer vector = cache.get(values.data(), {4}, *device_);
+    pjrt::SharedBuffer matrix = cache.get(values.data(), {2, 2}, *device_);
+    pjrt::SharedBuffer floats = cache.get(zeros.data(), {4}, *device_);
+    EXPECT_NE(vector->c_buffer(), matrix->c_buffer());
+    EXPECT_NE(vector->c_buffer(), floats->c_buffer());
+    EXPECT_EQ(matrix->dimensions(), (std::vector<int64_t>{2, 2}));
+    EXPECT_EQ(cache.stats().misses, 3);
+}
+
+TEST_F(ConstantCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+    const std::vector<float> a(256, 1.0f);
+    const std::vector<float> b(256, 2.0f);
+    const std::vector<float> c(256, 3.0f);
+    const size_t entryBytes = client_.transferToDevice(a.data(), {256}, *device_).get().onDeviceSizeInBytes();
+    pjrt::ConstantCache cache(client_, 2 * entryBytes);
+
+    pjrt::SharedBuffer heldA = cache.get(a.data(), {256}, *device_);
+    cache.get(b.data(), {256}, *device_);
+    cache.get(a.data(), {256}, *device_);
+    cache.get(c.data(), {256}, *device_);
+
+    pjrt::ConstantCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_EQ(stats.residentEntries, 2);
+    EXPECT_EQ(stats.residentBytes, 2 * entryBytes);
+
+    // `a` was used more recently than `b`, so it is still cached.
+    cache.get(a.data(), {256}, *device_);
+    EXPECT_EQ(cache.stats().hits, 2);
+    // Dropped entries stay valid for their holders.
+    EXPECT_EQ(heldA->toHost<float>().get(), a);
+}
+
+} // namespace
@@ -0,0 +1,100 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/deferredReleaseQueue.hpp"
+#include "pjrt/exception.hpp"
+
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class DeferredReleaseTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+
+    pjrt::Buffer upload(float value) {
+        const std::vector<float> data(256, value);
+        return client_.transferToDevice(data.data(), {256}, *device_).get();
+    }
+};
+
+TEST_F(DeferredReleaseTest, DestructorAndMoveAssignmentAreDeferred) {
+    // A long delay and large batch, so that nothing is freed before flush().
+    pjrt::DeferredReleaseQueue queue(context_, {/*batchSize=*/1000, /*maxDelay=*/std::chrono::milliseconds(10000)});
+    {
+        pjrt::Buffer first = upload(1.0f);
+        pjrt::Buffer second = upload(2.0f);
+        first = std::move(second);
+        EXPECT_EQ(first.toHost<float>().get()[0], 2.0f);
+    }
+    EXPECT_EQ(queue.stats().queueLength, 2);
+
+    queue.flush();
+    const pjrt::DeferredReleaseQueue::Stats stats = queue.stats();
+    EXPECT_EQ(stats.queueLength, 0);
+    EXPECT_EQ(stats.peakQueueLength, 2);
+    EXPECT_EQ(stats.buffersFreed, 2);
+    EXPECT_GE(stats.bytesFreed, 2 * 256 * sizeof(float));
+    EXPECT_EQ(stats.failures, 0);
+}
+
+TEST_F(DeferredReleaseTest, FullBatchIsFreedWithoutFlush) {
+    pjrt::DeferredReleaseQueue queue(context_, {/*batchSize=*/4, /*maxDelay=*/std::chrono::milliseconds(10000)});
+    for (int i = 0; i < 4; ++i) {
+        pjrt::Buffer buffer = upload(static_cast<float>(i));
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (queue.stats().buffersFreed < 4 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(queue.stats().buffersFreed, 4);
+}
+
+TEST_F(DeferredReleaseTest, LoneBufferIsFreedAfterMaxDelay) {
+    // The queue sleeps untimed while idle, so the first buffer has to wake it and arm the delay.
+    pjrt::DeferredReleaseQueue queue(context_, {/*batchSize=*/1000, /*maxDelay=*/std::chrono::milliseconds(10)});
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    {
+        pjrt::Buffer buffer = upload(1.0f);
+    }
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (queue.stats().buffersFreed < 1 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(queue.stats().buffersFreed, 1);
+    EXPECT_EQ(queue.stats().batches, 1);
+}
+
+TEST_F(DeferredReleaseTest, ExplicitDestroyStaysSynchronous) {
+    pjrt::DeferredReleaseQueue queue(context_);
+    pjrt::Buffer buffer = upload(1.0f);
+    ASSERT_NO_THROW(buffer.destroy());
+    EXPECT_EQ(buffer.c_buffer(), nullptr);
+    queue.flush();
+    EXPECT_EQ(queue.stats().buffersFreed, 0);
+}
+
+TEST_F(DeferredReleaseTest, DetachesOnDestruction) {
+    std::optional<pjrt::DeferredReleaseQueue> queue;
+    queue.emplace(context_);
+    EXPECT_THROW(pjrt::DeferredReleaseQueue second(context_), pjrt::Exception);
+    pjrt::Buffer buffer = upload(1.0f);
+    queue.reset();
+    EXPECT_EQ(context_.deferredReleaseQueue_.load(), nullptr);
+    // Freed synchronously now that no queue is attached.
+    buffer = upload(2.0f);
+}
+
+} // namespace
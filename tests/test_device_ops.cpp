@@ -0,0 +1,142 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/deviceOps.hpp"
+#include "pjrt/exception.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class DeviceOpsTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+
+    template <typename T>
+    pjrt::Buffer upload(const std::vector<T> &data, const pjrt::Shape &shape) {
+        return client_.transferToDevice(data.data(), shape, *device_).get();
+    }
+};
+
+// 2x3 matrix [[0, 1, 2], [3, 4, 5]].
+const std::vector<float> kMatrix = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+
+TEST_F(DeviceOpsTest, Slice) {
+    pjrt::DeviceOps ops(client_, *device_);
+    pjrt::Buffer matrix = upload(kMatrix, {2, 3});
+    pjrt::Buffer column = ops.slice(matrix, {0, 1}, {2, 2});
+    EXPECT_EQ(column.dimensions(), (pjrt::Shape{2, 1}));
+    EXPECT_EQ(column.toHost<float>().get(), (std::vector<float>{1.0f, 4.0f}));
+
+    pjrt::Buffer strided = ops.slice(matrix, {1, 0}, {2, 3}, {1, 2});
+    EXPECT_EQ(strided.toHost<float>().get(), (std::vector<float>{3.0f, 5.0f}));
+
+    EXPECT_THROW(ops.slice(matrix, {0, 0}, {3, 3}), pjrt::Exception);
+}
+
+TEST_F(DeviceOpsTest, Concatenate) {
+    pjrt::DeviceOps ops(client_, *device_);
+    pjrt::Buffer matrix = upload(kMatrix, {2, 3});
+    pjrt::Buffer row = upload(std::vector<float>{6.0f, 7.0f, 8.0f}, {1, 3});
+    pjrt::Buffer joined = ops.concatenate({&matrix, &row}, /*axis=*/0);
+    EXPECT_EQ(joined.dimensions(), (pjrt::Shape{3, 3}));
+    EXPECT_EQ(joined.toHost<float>().get(), (std::vector<float>{0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f}));
+
+    EXPECT_THROW(ops.concatenate({&matrix, &row}, /*axis=*/1), pjrt::Exception);
+}
+
+TEST_F(DeviceOpsTest, ConvertAndReshape) {
+    pjrt::DeviceOps ops(client_, *device_);
+    pjrt::Buffer matrix = upload(kMatrix, {2, 3});
+    pjrt::Buffer integers = ops.convert(matrix, PJRT_Buffer_Type_S32);
+    pjrt::Buffer reshaped = ops.reshape(integers, {3, 2});
+    EXPECT_EQ(reshaped.dimensions(), (pjrt::Shape{3, 2}));
+    EXPECT_EQ(reshaped.toHost<int32_t>().get(), (std::vector<int32_t>{0, 1, 2, 3, 4, 5}));
+
+    EXPECT_THROW(ops.reshape(matrix, {4}), pjrt::Exception);
+}
+
+TEST_F(DeviceOpsTest, Pad) {
+    pjrt::DeviceOps ops(client_, *device_);
+    pjrt::Buffer vector = upload(std::vector<float>{1.0f, 2.0f}, {2});
+    pjrt::Buffer padded = ops.pad(vector, {1}, {2}, /*paddingValue=*/-1.0, /*interior=*/{1});
+    EXPECT_EQ(padded.toHost<float>().get(), (std::vector<float>{-1.0f, 1.0f, -1.0f, 2.0f, -1.0f, -1.0f}));
+}
+
+TEST_F(DeviceOpsTest, Gather) {
+    pjrt::DeviceOps ops(client_, *device_);
+    pjrt::Buffer matrix = upload(kMatrix, {2, 3});
+    pjrt::Buffer rowIndices = upload(std::vector<int32_t>{1, 1, 0}, {3});
+    pjrt::Buffer rows = ops.gather(matrix, rowIndices);
+    EXPECT_EQ(rows.dimensions(), (pjrt::Shape{3, 3}));
+    EXPECT_EQ(rows.toHost<float>().get(), (std::vector<float>{3.0f, 4.0f, 5.0f, 3.0f, 4.0f, 5.0f, 0.0f, 1.0f, 2.0f}));
+
+    pjrt::Buffer columnIndices = upload(std::vector<int64_t>{2, 0}, {2});
+    pjrt::Buffer columns = ops.gather(matrix, columnIndices, /*axis=*/1);
+    EXPECT_EQ(columns.dimensions(), (pjrt::Shape{2, 2}));
+    EXPECT_EQ(columns.toHost<float>().get(), (std::vector<float>{2.0f, 0.0f, 5.0f, 3.0f}));
+}
+
+TEST_F(DeviceOpsTest, CachesProgramsBySignature) {
+    pjrt::DeviceOps ops(client_, *device_);
+    pjrt::Buffer matrix = upload(kMatrix, {2, 3});
+    pjrt::Buffer other = upload(std::vector<float>{6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f}, {2, 3});
+    pjrt::Buffer first = ops.slice(matrix, {0, 0}, {1, 3});
+    pjrt::Buffer second = ops.slice(other, {0, 0}, {1, 3});
+    EXPECT_EQ(second.toHost<float>().get(), (std::vector<float>{6.0f, 7.0f, 8.0f}));
+    EXPECT_EQ(ops.numCachedPrograms(), 1);
+    EXPECT_EQ(ops.stats().programCacheHits, 1);
+
+    // The start of the window is an operand, so moving it reuses the program.
+    pjrt::Buffer third = ops.slice(matrix, {1, 0}, {2, 3});
+    EXPECT_EQ(third.toHost<float>().get(), (std::vector<float>{3.0f, 4.0f, 5.0f}));
+    EXPECT_EQ(ops.numCachedPrograms(), 1);
+    EXPECT_EQ(ops.stats().programCacheHits, 2);
+
+    pjrt::Buffer fourth = ops.slice(matrix, {0, 0}, {2, 2});
+    EXPECT_EQ(ops.numCachedPrograms(), 2);
+    EXPECT_EQ(ops.stats().programsCompiled, 2);
+}
+
+TEST_F(DeviceOpsTest, PaddingValuesShareAProgram) {
+    pjrt::DeviceOps ops(client_, *device_);
+    pjrt::Buffer vector = upload(std::vector<int32_t>{1, 2}, {2});
+    for (int value = 0; value < 4; ++value) {
+        pjrt::Buffer padded = ops.pad(vector, {1}, {0}, /*paddingValue=*/value);
+        EXPECT_EQ(padded.toHost<int32_t>().get(), (std::vector<int32_t>{value, 1, 2}));
+    }
+    EXPECT_EQ(ops.stats().programsCompiled, 1);
+    EXPECT_THROW(ops.pad(vector, {1}, {0}, /*paddingValue=*/0.5), pjrt::Exception);
+}
+
+TEST_F(DeviceOpsTest, EvictsLeastRecentlyUsedPrograms) {
+    pjrt::DeviceOps::Options options;
+    options.maxPrograms = 2;
+    pjrt::DeviceOps ops(client_, *device_, options);
+    pjrt::Buffer matrix = upload(kMatrix, {2, 3});
+    pjrt::Buffer first = ops.slice(matrix, {0, 0}, {1, 1});
+    pjrt::Buffer second = ops.slice(matrix, {0, 0}, {1, 2});
+    // Uses the first program again, so that the second one is the least recently used.
+    pjrt::Buffer third = ops.slice(matrix, {1, 1}, {2, 2});
+    pjrt::Buffer fourth = ops.slice(matrix, {0, 0}, {1, 3});
+    EXPECT_EQ(ops.numCachedPrograms(), 2);
+    EXPECT_EQ(ops.stats().programsEvicted, 1);
+    EXPECT_EQ(fourth.toHost<float>().get(), (std::vector<float>{0.0f, 1.0f, 2.0f}));
+
+    pjrt::Buffer fifth = ops.slice(matrix, {1, 0}, {2, 1});
+    EXPECT_EQ(fifth.toHost<float>().get(), (std::vector<float>{3.0f}));
+    EXPECT_EQ(ops.stats().programCacheHits, 2);
+}
+
+} // namespace
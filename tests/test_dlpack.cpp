@@ -0,0 +1,61 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/dlpack.hpp"
+
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class DLPackTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(DLPackTest, ExportDescribesBuffer) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2, 3}, *device_).get();
+
+    DLManagedTensor *managedTensor = nullptr;
+    ASSERT_NO_THROW(managedTensor = buffer.toDLPack());
+    ASSERT_NE(managedTensor, nullptr);
+    EXPECT_EQ(buffer.c_buffer(), nullptr) << "Ownership should have moved into the DLPack tensor.";
+
+    const DLTensor &tensor = managedTensor->dl_tensor;
+    EXPECT_EQ(tensor.ndim, 2);
+    EXPECT_EQ(tensor.shape[0], 2);
+    EXPECT_EQ(tensor.shape[1], 3);
+    EXPECT_EQ(tensor.strides[0], 3);
+    EXPECT_EQ(tensor.strides[1], 1);
+    EXPECT_EQ(tensor.dtype.code, kDLFloat);
+    EXPECT_EQ(tensor.dtype.bits, 32);
+    if (tensor.device.device_type == kDLCPU) {
+        // The exported memory is directly readable.
+        const float *data = static_cast<const float*>(tensor.data);
+        EXPECT_EQ(std::vector<float>(data, data + input.size()), input);
+    }
+    managedTensor->deleter(managedTensor);
+}
+
+TEST_F(DLPackTest, RoundTripWithoutCopy) {
+    const std::vector<int32_t> input = {1, 2, 3, 4};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+
+    DLManagedTensor *managedTensor = buffer.toDLPack();
+    pjrt::Buffer view = client_.fromDLPack(managedTensor);
+    EXPECT_EQ(view.dimensions(), std::vector<int64_t>{4});
+    EXPECT_EQ(view.elementType(), PJRT_Buffer_Type_S32);
+    EXPECT_EQ(view.toHost<int32_t>().get(), input);
+}
+
+} // namespace
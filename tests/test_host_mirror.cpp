@@ -0,0 +1,166 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/loadedExecutable.hpp"
+#include "pjrt/rawBuffer.hpp"
+
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+// Adds its arguments, reusing the first argument's storage for the result so that PJRT donates it.
+const std::string kDonatingAddProgram = R"delim(
+module @jit_add attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<4xf32> {tf.aliasing_output = 0 : i32}, %arg1: tensor<4xf32>) -> (tensor<4xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg1 : tensor<4xf32>
+    return %0 : tensor<4xf32>
+  }
+})delim";
+
+class HostMirrorTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(HostMirrorTest, RepeatedReadsShareOneReadback) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+
+    std::shared_future<std::vector<float>> first = buffer.mirroredToHost<float>();
+    std::shared_future<std::vector<float>> second = buffer.mirroredToHost<float>();
+    EXPECT_EQ(first.get(), input);
+    // Both futures refer to the same shared state, and so to the same host vector.
+    EXPECT_EQ(&first.get(), &second.get());
+}
+
+TEST_F(HostMirrorTest, ConcurrentReadersShareOneReadback) {
+    const std::vector<int32_t> input = {5, 6, 7, 8};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+
+    constexpr int kNumThreads = 8;
+    std::vector<const std::vector<int32_t>*> results(kNumThreads, nullptr);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            results[t] = &buffer.mirroredToHost<int32_t>().get();
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < kNumThreads; ++t) {
+        EXPECT_EQ(results[t], results[0]) << "Thread " << t;
+    }
+    EXPECT_EQ(*results[0], input);
+}
+
+TEST_F(HostMirrorTest, ReplacingTheBufferDropsTheMirror) {
+    const std::vector<float> before = {1.0f, 2.0f, 3.0f, 4.0f};
+    const std::vector<float> after = {4.0f, 3.0f, 2.0f, 1.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(before.data(), {4}, *device_).get();
+    EXPECT_EQ(buffer.mirroredToHost<float>().get(), before);
+
+    buffer = client_.transferToDevice(after.data(), {4}, *device_).get();
+    EXPECT_EQ(buffer.mirroredToHost<float>().get(), after);
+}
+
+TEST_F(HostMirrorTest, MirrorFollowsMovedBuffer) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+    const std::vector<float> *mirrored = &buffer.mirroredToHost<float>().get();
+
+    pjrt::Buffer moved(std::move(buffer));
+    EXPECT_EQ(&moved.mirroredToHost<float>().get(), mirrored);
+}
+
+TEST_F(HostMirrorTest, ExplicitInvalidationReadsAgain) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+    std::shared_future<std::vector<float>> first = buffer.mirroredToHost<float>();
+
+    buffer.invalidateHostMirror();
+    std::shared_future<std::vector<float>> second = buffer.mirroredToHost<float>();
+    EXPECT_NE(&first.get(), &second.get());
+    EXPECT_EQ(second.get(), input);
+}
+
+TEST_F(HostMirrorTest, DonationDropsTheMirror) {
+    pjrt::LoadedExecutable executable = client_.compileFromStableHloString(kDonatingAddProgram);
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer lhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    pjrt::Buffer rhs = client_.transferToDevice(input.data(), {4}, *device_).get();
+    std::shared_future<std::vector<float>> mirrored = lhs.mirroredToHost<float>();
+    mirrored.wait();
+
+    std::vector<pjrt::Buffer*> arguments = {&lhs, &rhs};
+    std::vector<pjrt::Buffer> outputs = executable.execute(*device_, arguments).get();
+    if (!lhs.isDeleted()) {
+        GTEST_SKIP() << "The PJRT plugin did not donate the argument.";
+    }
+    // The mirror of the donated buffer is gone, so reading it now reports the deleted buffer instead of stale data.
+    EXPECT_ANY_THROW(lhs.mirroredToHost<float>().get());
+    EXPECT_EQ(outputs[0].toHost<float>().get(), (std::vector<float>{2.0f, 4.0f, 6.0f, 8.0f}));
+}
+
+TEST_F(HostMirrorTest, RawWriteDropsTheMirror) {
+    if (!pjrt::RawBuffer::isSupported(context_)) {
+        GTEST_SKIP() << "The PJRT plugin does not support the RawBuffer extension.";
+    }
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+    EXPECT_EQ(buffer.mirroredToHost<float>().get(), input);
+
+    pjrt::RawBuffer raw(buffer);
+    const float replacement = 9.0f;
+    raw.write(&replacement, 0, sizeof(float)).get();
+    EXPECT_EQ(buffer.mirroredToHost<float>().get(), (std::vector<float>{9.0f, 2.0f, 3.0f, 4.0f}));
+}
+
+TEST_F(HostMirrorTest, RawWriteDropsAMirrorFilledAfterWrapping) {
+    if (!pjrt::RawBuffer::isSupported(context_)) {
+        GTEST_SKIP() << "The PJRT plugin does not support the RawBuffer extension.";
+    }
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {4}, *device_).get();
+    pjrt::RawBuffer raw(buffer);
+    EXPECT_EQ(buffer.mirroredToHost<float>().get(), input);
+
+    const float replacement = 9.0f;
+    raw.write(&replacement, 0, sizeof(float)).get();
+    EXPECT_EQ(buffer.mirroredToHost<float>().get(), (std::vector<float>{9.0f, 2.0f, 3.0f, 4.0f}));
+}
+
+TEST_F(HostMirrorTest, ReadsDuringARawWriteAreNotKept) {
+    if (!pjrt::RawBuffer::isSupported(context_)) {
+        GTEST_SKIP() << "The PJRT plugin does not support the RawBuffer extension.";
+    }
+    const std::vector<float> input(1024, 0.0f);
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {1024}, *device_).get();
+    pjrt::RawBuffer raw(buffer);
+
+    for (int round = 1; round <= 20; ++round) {
+        const std::vector<float> values(1024, static_cast<float>(round));
+        std::future<void> written = raw.write(values.data(), 0, values.size() * sizeof(float));
+        // Races with the write: may see either contents, but must not be kept as the mirror.
+        std::thread reader([&]() { buffer.mirroredToHost<float>().get(); });
+        buffer.mirroredToHost<float>().get();
+        reader.join();
+        written.get();
+        EXPECT_EQ(buffer.mirroredToHost<float>().get(), values) << "Round " << round;
+    }
+}
+
+} // namespace
@@ -0,0 +1,87 @@
+#include "pjrt/hostPacker.hpp"
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+pjrt::HostPacker::Options smallChunkOptions(size_t nonTemporalThreshold = 0) {
+    // Split even small inputs across threads so that the parallel path is exercised.
+    pjrt::HostPacker::Options options;
+    options.numThreads = 4;
+    options.minBytesPerThread = 64;
+    options.nonTemporalThreshold = nonTemporalThreshold;
+    return options;
+}
+
+TEST(HostPackerTest, ParallelForCoversRangeOnce) {
+    pjrt::HostPacker packer(smallChunkOptions());
+    EXPECT_EQ(packer.numThreads(), 4);
+
+    std::vector<int> visits(1000, 0);
+    packer.parallelFor(visits.size(), /*minCountPerThread=*/1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+    EXPECT_EQ(std::vector<int>(visits.size(), 1), visits);
+}
+
+TEST(HostPackerTest, ParallelForRethrows) {
+    pjrt::HostPacker packer(smallChunkOptions());
+    EXPECT_THROW(packer.parallelFor(100, 1, [](size_t begin, size_t) {
+        if (begin != 0) {
+            throw std::runtime_error("chunk failed");
+        }
+    }), std::runtime_error);
+
+    // The packer remains usable.
+    size_t total = 0;
+    packer.parallelFor(10, 10, [&](size_t begin, size_t end) { total += end - begin; });
+    EXPECT_EQ(total, 10);
+}
+
+TEST(HostPackerTest, CopyWithAndWithoutStreamingStores) {
+    std::vector<uint8_t> source(100003);
+    std::iota(source.begin(), source.end(), 0);
+    for (size_t threshold : {size_t{1}, size_t{1} << 30}) {
+        pjrt::HostPacker packer(smallChunkOptions(threshold));
+        // Offset by one byte so that the destination is not 16-byte aligned.
+        std::vector<uint8_t> destination(source.size() + 1, 0);
+        packer.copy(destination.data() + 1, source.data(), source.size());
+        EXPECT_EQ(std::vector<uint8_t>(destination.begin() + 1, destination.end()), source);
+    }
+}
+
+TEST(HostPackerTest, ConvertScales) {
+    pjrt::HostPacker packer(smallChunkOptions(/*nonTemporalThreshold=*/1));
+    std::vector<uint8_t> source(5000);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<uint8_t>(i % 256);
+    }
+    std::vector<float> destination(source.size());
+    packer.convert(destination.data(), source.data(), source.size(), 0.5f);
+    for (size_t i = 0; i < source.size(); ++i) {
+        ASSERT_EQ(destination[i], source[i] * 0.5f) << "at " << i;
+    }
+}
+
+TEST(HostPackerTest, GatherAndGatherConvertRows) {
+    pjrt::HostPacker packer(smallChunkOptions());
+    const std::vector<std::vector<uint8_t>> images = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+    const std::vector<const uint8_t*> rows = {images[2].data(), images[0].data()};
+
+    std::vector<uint8_t> raw(6);
+    packer.gather(raw.data(), reinterpret_cast<const void *const *>(rows.data()), rows.size(), 3);
+    EXPECT_EQ(raw, (std::vector<uint8_t>{7, 8, 9, 1, 2, 3}));
+
+    std::vector<float> converted(6);
+    packer.gatherConvert(converted.data(), rows.data(), rows.size(), 3, 2.0f);
+    EXPECT_EQ(converted, (std::vector<float>{14, 16, 18, 2, 4, 6}));
+}
+
+} // namespace
@@ -0,0 +1,70 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/hostView.hpp"
+#include "pjrt/tensor.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class HostViewTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(HostViewTest, ViewsBufferContents) {
+    const std::vector<int32_t> input = {1, 2, 3, 4, 5, 6};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2, 3}, *device_).get();
+
+    pjrt::HostView<int32_t> view = buffer.hostView<int32_t>();
+    EXPECT_EQ(view.isZeroCopy(), buffer.isOnCpu());
+    ASSERT_EQ(view.size(), input.size());
+    EXPECT_EQ(std::vector<int32_t>(view.begin(), view.end()), input);
+}
+
+TEST_F(HostViewTest, ZeroCopyViewSeesBufferMemory) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {3}, *device_).get();
+    if (!buffer.isOnCpu()) {
+        GTEST_SKIP() << "Buffer is not on the CPU; hostView() copies.";
+    }
+
+    pjrt::HostView<float> first = buffer.hostView<float>();
+    pjrt::HostView<float> second = buffer.hostView<float>();
+    EXPECT_TRUE(first.isZeroCopy());
+    EXPECT_EQ(first.data(), second.data());
+
+    // Moving keeps the pin; only one of the two releases it.
+    pjrt::HostView<float> moved(std::move(first));
+    EXPECT_TRUE(moved.isZeroCopy());
+    EXPECT_FALSE(first.isZeroCopy());
+    EXPECT_EQ(moved[2], 3.0f);
+}
+
+TEST_F(HostViewTest, RejectsWrongElementType) {
+    const std::vector<float> input = {1.0f, 2.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2}, *device_).get();
+    EXPECT_THROW(buffer.hostView<int32_t>(), pjrt::Exception);
+}
+
+TEST_F(HostViewTest, TensorHostView) {
+    const std::vector<double> input = {0.5, 1.5};
+    pjrt::Tensor<double> tensor(client_.transferToDevice(input.data(), {2}, *device_).get());
+    pjrt::HostView<double> view = tensor.hostView();
+    EXPECT_EQ(std::vector<double>(view.begin(), view.end()), input);
+}
+
+} // namespace
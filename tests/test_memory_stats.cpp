@@ -0,0 +1,66 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/memoryWatermarkSampler.hpp"
+
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class MemoryStatsTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(MemoryStatsTest, ReportsBytesInUse) {
+    pjrt::MemoryStats before;
+    try {
+        before = device_->memoryStats();
+    } catch (const pjrt::Exception &e) {
+        GTEST_SKIP() << "The PJRT plugin does not report memory statistics: " << e.what();
+    }
+    EXPECT_GE(before.bytesInUse, 0);
+
+    const std::vector<float> data(1 << 20, 1.0f);
+    pjrt::Buffer buffer = client_.transferToDevice(data.data(), {1 << 20}, *device_).get();
+    const pjrt::MemoryStats after = device_->memoryStats();
+    EXPECT_GE(after.bytesInUse, before.bytesInUse);
+    if (after.peakBytesInUse) {
+        EXPECT_GE(*after.peakBytesInUse, after.bytesInUse);
+    }
+}
+
+TEST_F(MemoryStatsTest, SamplerRecordsPhases) {
+    pjrt::MemoryWatermarkSampler sampler(*device_, std::chrono::milliseconds(1));
+    sampler.setPhase("upload");
+    const std::vector<float> data(1 << 20, 1.0f);
+    pjrt::Buffer buffer = client_.transferToDevice(data.data(), {1 << 20}, *device_).get();
+    sampler.setPhase("idle");
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    sampler.stop();
+
+    if (!sampler.supported()) {
+        GTEST_SKIP() << "The PJRT plugin does not report memory statistics.";
+    }
+    const std::vector<pjrt::MemoryWatermarkSampler::PhaseWatermark> watermarks = sampler.watermarks();
+    ASSERT_GE(watermarks.size(), 2);
+    EXPECT_EQ(watermarks[watermarks.size() - 2].phase, "upload");
+    EXPECT_EQ(watermarks.back().phase, "idle");
+    EXPECT_GE(watermarks.back().numSamples, 1);
+    EXPECT_GE(watermarks.back().peakBytesInUse, 0);
+}
+
+} // namespace
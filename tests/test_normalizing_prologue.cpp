@@ -0,0 +1,69 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/normalizingPrologue.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kScaleAndOffsetProgram = R"delim(
+module @jit_scale_and_offset attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<2x3xf32> {mhlo.layout_mode = "default"}, %arg1: tensor<f32>) -> (tensor<2x3xf32> {jax.result_info = "[0]"}, tensor<f32> {jax.result_info = "[1]"}) {
+    %0 = stablehlo.broadcast_in_dim %arg1, dims = [] : (tensor<f32>) -> tensor<2x3xf32>
+    %1 = stablehlo.add %arg0, %0 : tensor<2x3xf32>
+    return %1, %arg1 : tensor<2x3xf32>, tensor<f32>
+  }
+})delim";
+
+TEST(NormalizingPrologueTest, RewritesSignature) {
+    const std::string program = pjrt::addNormalizingPrologue(kScaleAndOffsetProgram, {{/*index=*/0, PJRT_Buffer_Type_U8, /*scale=*/0.5}});
+
+    EXPECT_NE(program.find("func.func private @main_inner(%arg0: tensor<2x3xf32> {mhlo.layout_mode = \"default\"}, %arg1: tensor<f32>)"), std::string::npos) << program;
+    EXPECT_NE(program.find("func.func public @main(%arg0: tensor<2x3xui8>, %arg1: tensor<f32>) -> (tensor<2x3xf32> {jax.result_info = \"[0]\"}, tensor<f32> {jax.result_info = \"[1]\"})"), std::string::npos) << program;
+    EXPECT_NE(program.find("stablehlo.convert %arg0 : (tensor<2x3xui8>) -> tensor<2x3xf32>"), std::string::npos) << program;
+    EXPECT_NE(program.find("%results:2 = func.call @main_inner(%normalized0, %arg1)"), std::string::npos) << program;
+    EXPECT_NE(program.find("return %results#0, %results#1 : tensor<2x3xf32>, tensor<f32>"), std::string::npos) << program;
+    EXPECT_EQ(program.back(), '}');
+}
+
+TEST(NormalizingPrologueTest, RejectsInvalidArguments) {
+    EXPECT_THROW(pjrt::addNormalizingPrologue(kScaleAndOffsetProgram, {{/*index=*/2}}), pjrt::Exception);
+    EXPECT_THROW(pjrt::addNormalizingPrologue("module {}", {{/*index=*/0}}), pjrt::Exception);
+}
+
+class NormalizingPrologueExecutionTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(NormalizingPrologueExecutionTest, ExecutesWithCompactInput) {
+    const std::string program = pjrt::addNormalizingPrologue(kScaleAndOffsetProgram, {{/*index=*/0, PJRT_Buffer_Type_U8, /*scale=*/0.5}});
+    std::optional<pjrt::LoadedExecutable> executable;
+    ASSERT_NO_THROW(executable = client_.compileFromStableHloString(program)) << program;
+
+    const std::vector<uint8_t> pixels = {0, 2, 4, 6, 8, 10};
+    const float offset = 1.0f;
+    pjrt::Buffer pixelBuffer = client_.transferToDevice(pixels.data(), {2, 3}, *device_).get();
+    pjrt::Buffer offsetBuffer = client_.transferToDevice(&offset, {}, *device_).get();
+
+    std::vector<pjrt::Buffer*> arguments = {&pixelBuffer, &offsetBuffer};
+    std::vector<pjrt::Buffer> results = executable->execute(*device_, arguments).get();
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_EQ(results[0].toHost<float>().get(), (std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+}
+
+} // namespace
@@ -0,0 +1,112 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/loadedExecutable.hpp"
+#include "pjrt/offloadManager.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kAddProgram = R"delim(
+module @jit_add attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<256xf32>, %arg1: tensor<256xf32>) -> (tensor<256xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg1 : tensor<256xf32>
+    return %0 : tensor<256xf32>
+  }
+})delim";
+
+class OffloadManagerTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+    std::optional<pjrt::OffloadManager> manager_;
+    size_t bufferBytes_{0};
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+        bufferBytes_ = upload(0.0f).onDeviceSizeInBytes();
+        try {
+            // Room for two buffers.
+            manager_.emplace(*device_, 2 * bufferBytes_);
+        } catch (const pjrt::Exception &exception) {
+            GTEST_SKIP() << exception.what();
+        }
+    }
+
+    pjrt::Buffer upload(float value) {
+        const std::vector<float> data(256, value);
+        return client_.transferToDevice(data.data(), {256}, *device_).get();
+    }
+};
+
+TEST_F(OffloadManagerTest, EvictsLeastRecentlyUsed) {
+    const pjrt::OffloadManager::Id a = manager_->add(upload(1.0f));
+    const pjrt::OffloadManager::Id b = manager_->add(upload(2.0f));
+    manager_->acquire({a});
+    const pjrt::OffloadManager::Id c = manager_->add(upload(3.0f));
+
+    EXPECT_TRUE(manager_->isResident(a));
+    EXPECT_FALSE(manager_->isResident(b));
+    EXPECT_TRUE(manager_->isResident(c));
+
+    const pjrt::OffloadManager::Stats stats = manager_->stats();
+    EXPECT_EQ(stats.swapOuts, 1);
+    EXPECT_EQ(stats.residentBuffers, 2);
+    EXPECT_EQ(stats.residentBytes, 2 * bufferBytes_);
+    EXPECT_EQ(stats.offloadedBuffers, 1);
+}
+
+TEST_F(OffloadManagerTest, SwapsBackInOnAccess) {
+    const pjrt::OffloadManager::Id a = manager_->add(upload(1.0f));
+    manager_->add(upload(2.0f));
+    manager_->add(upload(3.0f));
+    ASSERT_FALSE(manager_->isResident(a));
+
+    std::vector<pjrt::Buffer*> buffers = manager_->acquire({a});
+    ASSERT_EQ(buffers.size(), 1);
+    EXPECT_TRUE(manager_->isResident(a));
+    EXPECT_EQ(buffers[0]->memory().kind(), device_->defaultMemory().kind());
+    EXPECT_EQ(buffers[0]->toHost<float>().get(), std::vector<float>(256, 1.0f));
+
+    const pjrt::OffloadManager::Stats stats = manager_->stats();
+    EXPECT_EQ(stats.swapIns, 1);
+    EXPECT_EQ(stats.swapOuts, 2);
+    EXPECT_GT(stats.swapInTime.count(), 0);
+}
+
+TEST_F(OffloadManagerTest, ExecuteSwapsInArguments) {
+    pjrt::LoadedExecutable executable = client_.compileFromStableHloString(kAddProgram);
+    const pjrt::OffloadManager::Id a = manager_->add(upload(1.0f));
+    const pjrt::OffloadManager::Id b = manager_->add(upload(2.0f));
+    manager_->add(upload(3.0f));
+    manager_->add(upload(4.0f));
+    ASSERT_FALSE(manager_->isResident(a));
+    ASSERT_FALSE(manager_->isResident(b));
+
+    std::vector<pjrt::Buffer> outputs = manager_->execute(executable, {a, b}).get();
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs[0].toHost<float>().get(), std::vector<float>(256, 3.0f));
+    EXPECT_TRUE(manager_->isResident(a));
+    EXPECT_TRUE(manager_->isResident(b));
+}
+
+TEST_F(OffloadManagerTest, RemoveReturnsDeviceBuffer) {
+    const pjrt::OffloadManager::Id a = manager_->add(upload(1.0f));
+    manager_->add(upload(2.0f));
+    manager_->add(upload(3.0f));
+
+    pjrt::Buffer buffer = manager_->remove(a);
+    EXPECT_EQ(buffer.memory().kind(), device_->defaultMemory().kind());
+    EXPECT_EQ(buffer.toHost<float>().get(), std::vector<float>(256, 1.0f));
+    EXPECT_THROW(manager_->isResident(a), pjrt::Exception);
+}
+
+} // namespace
@@ -0,0 +1,56 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/rawBuffer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class RawBufferTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        if (!pjrt::RawBuffer::isSupported(context_)) {
+            GTEST_SKIP() << "The PJRT plugin does not support the RawBuffer extension.";
+        }
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(RawBufferTest, WriteRowsInPlace) {
+    // A 4x2 table; overwrite row 2.
+    const std::vector<int32_t> table = {0, 1, 10, 11, 20, 21, 30, 31};
+    pjrt::Buffer buffer = client_.transferToDevice(table.data(), {4, 2}, *device_).get();
+
+    pjrt::RawBuffer rawBuffer(buffer);
+    EXPECT_EQ(rawBuffer.onDeviceSizeInBytes(), table.size() * sizeof(int32_t));
+
+    const std::array<int32_t, 2> row = {-20, -21};
+    ASSERT_NO_THROW(rawBuffer.write(row.data(), 2 * 2 * sizeof(int32_t), sizeof(row)).get());
+    EXPECT_EQ(buffer.toHost<int32_t>().get(), (std::vector<int32_t>{0, 1, 10, 11, -20, -21, 30, 31}));
+
+    std::array<int32_t, 2> readRow{};
+    ASSERT_NO_THROW(rawBuffer.read(readRow.data(), 2 * 2 * sizeof(int32_t), sizeof(readRow)).get());
+    EXPECT_EQ(readRow, row);
+}
+
+TEST_F(RawBufferTest, RejectsOutOfBoundsWrite) {
+    const std::vector<float> data(4, 0.0f);
+    pjrt::Buffer buffer = client_.transferToDevice(data.data(), {4}, *device_).get();
+    pjrt::RawBuffer rawBuffer(buffer);
+    const float value = 1.0f;
+    EXPECT_THROW(rawBuffer.write(&value, 4 * sizeof(float), sizeof(value)), pjrt::Exception);
+}
+
+} // namespace
@@ -0,0 +1,60 @@
+#include "pjrt/shape.hpp"
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(ShapeTest, ScalarIsEmpty) {
+    const pjrt::Shape scalar = {};
+    EXPECT_TRUE(scalar.empty());
+    EXPECT_EQ(scalar.size(), 0);
+    EXPECT_EQ(scalar.numElements(), 1);
+}
+
+TEST(ShapeTest, StoresDimensionsInline) {
+    const pjrt::Shape shape = {2, 3, 4};
+    EXPECT_EQ(shape.size(), 3);
+    EXPECT_EQ(shape[1], 3);
+    EXPECT_EQ(shape.numElements(), 24);
+    // The data lives inside the object itself.
+    const char *begin = reinterpret_cast<const char*>(&shape);
+    const char *data = reinterpret_cast<const char*>(shape.data());
+    EXPECT_GE(data, begin);
+    EXPECT_LT(data, begin + sizeof(shape));
+}
+
+TEST(ShapeTest, ComparesWithVectors) {
+    const std::vector<int64_t> dims = {5, 7};
+    const pjrt::Shape shape = dims;
+    EXPECT_EQ(shape, dims);
+    EXPECT_EQ(shape.toVector(), dims);
+    EXPECT_NE(shape, (std::vector<int64_t>{5}));
+    EXPECT_TRUE(pjrt::Shape({1, 2}) < pjrt::Shape({1, 3}));
+    EXPECT_TRUE(pjrt::Shape({1}) < pjrt::Shape({1, 0}));
+}
+
+TEST(ShapeTest, SpillsLargeRanksToTheHeap) {
+    pjrt::Shape shape;
+    for (int64_t i = 1; i <= 10; ++i) {
+        shape.push_back(i);
+    }
+    ASSERT_EQ(shape.size(), 10);
+    for (int64_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(shape[i], i + 1);
+    }
+    const pjrt::Shape copy = shape;
+    EXPECT_EQ(copy, shape);
+    EXPECT_EQ(copy.numElements(), 3628800);
+}
+
+TEST(ShapeTest, Prints) {
+    std::ostringstream stream;
+    stream << pjrt::Shape({2, 3}) << pjrt::Shape{};
+    EXPECT_EQ(stream.str(), "[2, 3][]");
+}
+
+} // namespace
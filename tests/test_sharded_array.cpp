@@ -0,0 +1,141 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/loadedExecutable.hpp"
+#include "pjrt/shardedArray.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+constexpr size_t kNumDevices = 4;
+
+// Runs once per replica on that replica's shard of `x`, with the whole of `w`.
+const std::string kScaleAndAddProgram = R"delim(
+module @jit_scale_and_add {
+  func.func public @main(%arg0: tensor<2xf32>, %arg1: tensor<2xf32>) -> (tensor<2xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg0 : tensor<2xf32>
+    %1 = stablehlo.add %0, %arg1 : tensor<2xf32>
+    return %1 : tensor<2xf32>
+  }
+})delim";
+
+TEST(ShardingSpecTest, SplitDividesOneAxis) {
+    const pjrt::ShardingSpec spec = pjrt::ShardingSpec::split(1);
+    EXPECT_FALSE(spec.isReplicated());
+    EXPECT_EQ(spec.shardShape({6, 8}, 4), (pjrt::Shape{6, 2}));
+    EXPECT_EQ(spec.globalShape({6, 2}, 4), (pjrt::Shape{6, 8}));
+}
+
+TEST(ShardingSpecTest, ReplicatedKeepsTheShape) {
+    const pjrt::ShardingSpec spec = pjrt::ShardingSpec::replicated();
+    EXPECT_TRUE(spec.isReplicated());
+    EXPECT_EQ(spec.shardShape({6, 8}, 4), (pjrt::Shape{6, 8}));
+    EXPECT_EQ(spec.globalShape({6, 8}, 4), (pjrt::Shape{6, 8}));
+}
+
+TEST(ShardingSpecTest, RejectsUnevenSplits) {
+    EXPECT_THROW(pjrt::ShardingSpec::split(0).shardShape({6, 8}, 4), pjrt::Exception);
+    EXPECT_THROW(pjrt::ShardingSpec::split(2).shardShape({6, 8}, 2), pjrt::Exception);
+}
+
+class ShardedArrayTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    std::optional<pjrt::Client> client_;
+    std::vector<pjrt::DeviceView> devices_;
+
+    void SetUp() override {
+        // The CPU plugin exposes as many host devices as asked for. Other plugins may not know the option.
+        try {
+            client_.emplace(context_, std::vector<pjrt::ClientCreateOption>{{"cpu_device_count", int64_t{kNumDevices}}});
+        } catch (const pjrt::Exception &exception) {
+            GTEST_SKIP() << "The PJRT plugin does not accept cpu_device_count: " << exception.what();
+        }
+        if (client_->getNumDevices() < kNumDevices) {
+            GTEST_SKIP() << "Need at least " << kNumDevices << " devices.";
+        }
+        devices_ = client_->getDevices(kNumDevices);
+    }
+};
+
+TEST_F(ShardedArrayTest, SplitAlongOuterAxis) {
+    // 8x2, so each device gets two rows.
+    std::vector<float> input(16);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<float>(i);
+    }
+    pjrt::ShardedArray array = pjrt::ShardedArray::upload(*client_, input.data(), {8, 2}, pjrt::ShardingSpec::split(0), devices_).get();
+
+    ASSERT_EQ(array.numShards(), kNumDevices);
+    EXPECT_EQ(array.shape(), (pjrt::Shape{8, 2}));
+    for (size_t d = 0; d < kNumDevices; ++d) {
+        EXPECT_EQ(array.shard(d).dimensions(), (pjrt::Shape{2, 2}));
+        EXPECT_EQ(array.shard(d).device().device_, devices_[d].device_);
+        EXPECT_EQ(array.shard(d).toHost<float>().get(), std::vector<float>(input.begin() + 4 * d, input.begin() + 4 * (d + 1)));
+    }
+    EXPECT_EQ(array.toHost<float>().get(), input);
+}
+
+TEST_F(ShardedArrayTest, SplitAlongInnerAxis) {
+    // 2x8, so each device gets two columns of both rows.
+    std::vector<int32_t> input(16);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<int32_t>(i);
+    }
+    pjrt::ShardedArray array = pjrt::ShardedArray::upload(*client_, input.data(), {2, 8}, pjrt::ShardingSpec::split(1), devices_).get();
+
+    ASSERT_EQ(array.numShards(), kNumDevices);
+    EXPECT_EQ(array.shard(1).dimensions(), (pjrt::Shape{2, 2}));
+    EXPECT_EQ(array.shard(1).toHost<int32_t>().get(), (std::vector<int32_t>{2, 3, 10, 11}));
+    EXPECT_EQ(array.toHost<int32_t>().get(), input);
+}
+
+TEST_F(ShardedArrayTest, ReplicatedOnEveryDevice) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f};
+    pjrt::ShardedArray array = pjrt::ShardedArray::upload(*client_, input.data(), {3}, pjrt::ShardingSpec::replicated(), devices_).get();
+
+    ASSERT_EQ(array.numShards(), kNumDevices);
+    for (size_t d = 0; d < kNumDevices; ++d) {
+        EXPECT_EQ(array.shard(d).toHost<float>().get(), input);
+    }
+    EXPECT_EQ(array.toHost<float>().get(), input);
+}
+
+TEST_F(ShardedArrayTest, ExecuteOnAllDevices) {
+    pjrt::LoadedExecutable executable = client_->compileFromStableHloString(kScaleAndAddProgram, kNumDevices);
+    ASSERT_EQ(executable.addressableDevices().size(), kNumDevices);
+
+    const std::vector<float> x = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f};
+    const std::vector<float> w = {10.0f, 20.0f};
+    std::vector<pjrt::DeviceView> devices = executable.addressableDevices();
+    pjrt::ShardedArray xArray = pjrt::ShardedArray::upload(*client_, x.data(), {8}, pjrt::ShardingSpec::split(0), devices).get();
+    pjrt::ShardedArray wArray = pjrt::ShardedArray::upload(*client_, w.data(), {2}, pjrt::ShardingSpec::replicated(), devices).get();
+
+    std::vector<pjrt::ShardedArray> outputs = executable.execute({&xArray, &wArray}, {pjrt::ShardingSpec::split(0)}).get();
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs[0].sharding(), pjrt::ShardingSpec::split(0));
+    EXPECT_EQ(outputs[0].toHost<float>().get(), (std::vector<float>{10.0f, 22.0f, 14.0f, 26.0f, 18.0f, 30.0f, 22.0f, 34.0f}));
+}
+
+TEST_F(ShardedArrayTest, RejectsShardsOnTheWrongDevices) {
+    pjrt::LoadedExecutable executable = client_->compileFromStableHloString(kScaleAndAddProgram, kNumDevices);
+    std::vector<pjrt::DeviceView> reversed;
+    for (size_t d = kNumDevices; d-- > 0;) {
+        reversed.emplace_back(context_, executable.addressableDevices()[d].device_);
+    }
+    const std::vector<float> x(8, 1.0f);
+    const std::vector<float> w(2, 1.0f);
+    pjrt::ShardedArray xArray = pjrt::ShardedArray::upload(*client_, x.data(), {8}, pjrt::ShardingSpec::split(0), reversed).get();
+    pjrt::ShardedArray wArray = pjrt::ShardedArray::upload(*client_, w.data(), {2}, pjrt::ShardingSpec::replicated(), reversed).get();
+
+    EXPECT_THROW(executable.execute({&xArray, &wArray}, {pjrt::ShardingSpec::split(0)}), pjrt::Exception);
+}
+
+} // namespace
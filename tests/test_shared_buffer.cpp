@@ -0,0 +1,100 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/loadedExecutable.hpp"
+#include "pjrt/sharedBuffer.hpp"
+
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const std::string kAddProgram = R"delim(
+module @jit_add attributes {mhlo.num_partitions = 1 : i32, mhlo.num_replicas = 1 : i32} {
+  func.func public @main(%arg0: tensor<4xf32>, %arg1: tensor<4xf32>) -> (tensor<4xf32> {jax.result_info = ""}) {
+    %0 = stablehlo.add %arg0, %arg1 : tensor<4xf32>
+    return %0 : tensor<4xf32>
+  }
+})delim";
+
+class SharedBufferTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(SharedBufferTest, CopiesShareOneBuffer) {
+    const std::vector<float> weights = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::SharedBuffer shared(client_.transferToDevice(weights.data(), {4}, *device_).get());
+    EXPECT_EQ(shared.useCount(), 1);
+    {
+        pjrt::SharedBuffer copy = shared;
+        EXPECT_EQ(copy->c_buffer(), shared->c_buffer());
+        EXPECT_EQ(shared.useCount(), 2);
+    }
+    EXPECT_EQ(shared.useCount(), 1);
+    EXPECT_EQ(shared->toHost<float>().get(), weights);
+}
+
+TEST_F(SharedBufferTest, ArgumentsOutliveTheirOwners) {
+    pjrt::LoadedExecutable executable = client_.compileFromStableHloString(kAddProgram);
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+
+    std::future<std::vector<pjrt::Buffer>> result;
+    {
+        pjrt::SharedBuffer argument(client_.transferToDevice(input.data(), {4}, *device_).get());
+        result = executable.execute(*device_, {argument, argument});
+        // `argument` goes out of scope while the execution may still be running.
+    }
+    std::vector<pjrt::Buffer> outputs = result.get();
+    ASSERT_EQ(outputs.size(), 1);
+    EXPECT_EQ(outputs[0].toHost<float>().get(), (std::vector<float>{2.0f, 4.0f, 6.0f, 8.0f}));
+}
+
+TEST_F(SharedBufferTest, ConcurrentExecutionsShareWeights) {
+    pjrt::LoadedExecutable executable = client_.compileFromStableHloString(kAddProgram);
+    const std::vector<float> weights = {10.0f, 20.0f, 30.0f, 40.0f};
+    pjrt::SharedBuffer sharedWeights(client_.transferToDevice(weights.data(), {4}, *device_).get());
+
+    constexpr int kNumThreads = 4;
+    constexpr int kStepsPerThread = 8;
+    std::vector<std::thread> threads;
+    std::vector<char> correct(kNumThreads, false);
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            bool allCorrect = true;
+            for (int step = 0; step < kStepsPerThread; ++step) {
+                const std::vector<float> input(4, static_cast<float>(t));
+                pjrt::SharedBuffer inputBuffer(client_.transferToDevice(input.data(), {4}, *device_).get());
+                std::vector<pjrt::Buffer> outputs = executable.execute(*device_, {sharedWeights, inputBuffer}).get();
+                const std::vector<float> output = outputs[0].toHost<float>().get();
+                for (size_t i = 0; i < output.size(); ++i) {
+                    allCorrect = allCorrect && output[i] == weights[i] + static_cast<float>(t);
+                }
+            }
+            correct[t] = allCorrect;
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < kNumThreads; ++t) {
+        EXPECT_TRUE(correct[t]) << "Thread " << t;
+    }
+    // Shared arguments are never donated.
+    EXPECT_FALSE(sharedWeights->isDeleted());
+    EXPECT_EQ(sharedWeights->toHost<float>().get(), weights);
+}
+
+} // namespace
@@ -0,0 +1,89 @@
+#include "pjrt/buffer.hpp"
+#include "pjrt/client.hpp"
+#include "pjrt/context.hpp"
+#include "pjrt/exception.hpp"
+#include "pjrt/memoryLayout.hpp"
+#include "pjrt/memoryView.hpp"
+#include "pjrt/tensor.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class TensorTest : public ::testing::Test {
+protected:
+    pjrt::Context context_;
+    pjrt::Client client_{context_};
+    std::optional<pjrt::DeviceView> device_;
+
+    void SetUp() override {
+        ASSERT_NO_THROW(device_ = client_.getDevice(/*deviceNumber=*/0));
+        ASSERT_NE(device_->device_, nullptr) << "Failed to get a device for testing.";
+    }
+};
+
+TEST_F(TensorTest, BufferMetadataMatchesUpload) {
+    const std::vector<int32_t> input = {1, 2, 3, 4, 5, 6};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2, 3}, *device_).get();
+
+    EXPECT_EQ(buffer.elementType(), PJRT_Buffer_Type_S32);
+    EXPECT_EQ(buffer.device().device_, device_->device_);
+    EXPECT_EQ(buffer.memory().kind(), device_->defaultMemory().kind());
+    EXPECT_EQ(buffer.hostSizeInBytes(), input.size() * sizeof(int32_t));
+    EXPECT_GE(buffer.onDeviceSizeInBytes(), buffer.hostSizeInBytes());
+    EXPECT_EQ(buffer.memoryLayout().type(), PJRT_Buffer_MemoryLayout_Type_Tiled);
+    EXPECT_EQ(buffer.memoryLayout().minorToMajor().size(), 2);
+}
+
+TEST_F(TensorTest, MetadataFollowsMovedBuffer) {
+    const std::vector<float> input = {1.0f, 2.0f};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2}, *device_).get();
+    const PJRT_Buffer_Type type = buffer.elementType();
+
+    pjrt::Buffer moved(std::move(buffer));
+    EXPECT_EQ(moved.elementType(), type);
+    EXPECT_EQ(moved.toHost<float>().get(), input);
+}
+
+TEST(MemoryLayoutTest, DenseLayoutIsMajorToMinor) {
+    EXPECT_TRUE(pjrt::MemoryLayout::majorToMinor({0, 1, 2}).isDenseMajorToMinor());
+    EXPECT_FALSE(pjrt::MemoryLayout::majorToMinor({1, 0}).isDenseMajorToMinor());
+    EXPECT_FALSE(pjrt::MemoryLayout::tiled({0}, {{8}}).isDenseMajorToMinor());
+    EXPECT_FALSE(pjrt::MemoryLayout::strided({4}).isDenseMajorToMinor());
+}
+
+TEST_F(TensorTest, ReadsWholeTensor) {
+    const std::vector<float> input = {1.0f, 2.0f, 3.0f, 4.0f};
+    pjrt::Tensor<float> tensor(client_.transferToDevice(input.data(), {2, 2}, *device_).get());
+    EXPECT_EQ(tensor.numElements(), input.size());
+    EXPECT_EQ(tensor.toHost().get(), input);
+
+    std::array<float, 4> output{};
+    ASSERT_NO_THROW(tensor.toHost(output.data()).get());
+    EXPECT_EQ(std::vector<float>(output.begin(), output.end()), input);
+}
+
+TEST_F(TensorTest, ReadsScalar) {
+    const int64_t input = 42;
+    pjrt::Tensor<int64_t> tensor(client_.transferToDevice(&input, {}, *device_).get());
+    EXPECT_EQ(tensor.toHostScalar().get(), input);
+}
+
+TEST_F(TensorTest, RejectsWrongElementType) {
+    const std::vector<int32_t> input = {1, 2};
+    pjrt::Buffer buffer = client_.transferToDevice(input.data(), {2}, *device_).get();
+    EXPECT_THROW(pjrt::Tensor<float>{std::move(buffer)}, pjrt::Exception);
+}
+
+TEST_F(TensorTest, ScalarReadOfVectorThrows) {
+    const std::vector<float> input = {1.0f, 2.0f};
+    pjrt::Tensor<float> tensor(client_.transferToDevice(input.data(), {2}, *device_).get());
+    EXPECT_THROW(tensor.toHostScalar(), pjrt::Exception);
+}
+
+} // namespace